@@ -0,0 +1,97 @@
+#include "./aho_corasick.h"
+
+#include <stdexcept>
+
+namespace fsv {
+	// Initializer List Constructor
+	aho_corasick::aho_corasick(std::initializer_list<std::string_view> patterns)
+	: _class()
+	, _classes(0) {
+		build(std::vector<std::string_view>(patterns));
+	}
+
+	// pattern_count Member Function
+	auto aho_corasick::pattern_count() const noexcept -> std::size_t {
+		return _lengths.size();
+	}
+
+	// state_count Member Function
+	auto aho_corasick::state_count() const noexcept -> std::size_t {
+		return _output.size();
+	}
+
+	// Build the Automaton
+	// The trie is built straight into the dense table, with 0 marking a missing child (the root is never
+	// one). A breadth-first pass then sets failure and dictionary links and fills every missing transition
+	// from the failure state's row, which is already complete because it is shallower.
+	void aho_corasick::build(const std::vector<std::string_view>& patterns) {
+		for (const auto pattern : patterns) {
+			for (const char c : pattern) {
+				_class[static_cast<unsigned char>(c)] = 1;
+			}
+		}
+		_classes = 1;
+		for (auto& cls : _class) {
+			cls = cls != 0 ? static_cast<std::uint16_t>(_classes++) : std::uint16_t{0};
+		}
+
+		_next.assign(_classes, 0);
+		_output.assign(1, no_pattern);
+		_lengths.reserve(patterns.size());
+		_same.reserve(patterns.size());
+		for (const auto pattern : patterns) {
+			auto state = std::uint32_t{0};
+			for (const char c : pattern) {
+				auto& child = _next[state * _classes + _class[static_cast<unsigned char>(c)]];
+				if (child == 0) {
+					child = static_cast<std::uint32_t>(_output.size());
+					_output.push_back(no_pattern);
+					_next.resize(_next.size() + _classes, 0);
+				}
+				state = _next[state * _classes + _class[static_cast<unsigned char>(c)]];
+			}
+			const auto id = static_cast<std::uint32_t>(_lengths.size());
+			_lengths.push_back(pattern.size());
+			_same.push_back(no_pattern);
+			if (state != 0) {
+				auto* slot = &_output[state];
+				while (*slot != no_pattern) {
+					slot = &_same[*slot];
+				}
+				*slot = id;
+			}
+		}
+		if (static_cast<std::uint64_t>(_output.size()) * _classes > row_mask) {
+			throw std::length_error("aho_corasick: too many patterns");
+		}
+
+		auto fail = std::vector<std::uint32_t>(_output.size(), 0);
+		_dict.assign(_output.size(), 0);
+		auto queue = std::vector<std::uint32_t>();
+		queue.reserve(_output.size());
+		for (std::uint32_t c = 0; c < _classes; ++c) {
+			if (_next[c] != 0) {
+				queue.push_back(_next[c]);
+			}
+		}
+		for (std::size_t head = 0; head < queue.size(); ++head) {
+			const auto state = queue[head];
+			for (std::uint32_t c = 0; c < _classes; ++c) {
+				auto& child = _next[state * _classes + c];
+				const auto fallback = _next[fail[state] * _classes + c];
+				if (child == 0) {
+					child = fallback;
+					continue;
+				}
+				fail[child] = fallback;
+				_dict[child] = _output[fallback] != no_pattern ? fallback : _dict[fallback];
+				queue.push_back(child);
+			}
+		}
+
+		for (auto& entry : _next) {
+			const bool ends = _output[entry] != no_pattern || _dict[entry] != 0;
+			entry = entry * _classes | (ends ? has_output : 0U);
+		}
+	}
+} // namespace fsv
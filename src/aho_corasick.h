@@ -0,0 +1,142 @@
+#ifndef COMP6771_ASS2_AHO_CORASICK_H
+#define COMP6771_ASS2_AHO_CORASICK_H
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "./filtered_string_view.h"
+
+namespace fsv {
+	// Finds every occurrence of any of a fixed set of patterns in one pass over a view.
+	//
+	// The Aho-Corasick automaton is compiled into a dense DFA over byte classes (one class per byte that
+	// occurs in some pattern, one for all other bytes), so each character costs a class lookup and one
+	// table load. Entries hold the target's row offset, with the top bit flagging states that end a
+	// pattern. Views are fed run by run, so a match may span characters the view's predicate rejects.
+	class aho_corasick {
+	 public:
+		struct match {
+			std::size_t pattern;
+			std::size_t index;
+
+			friend auto operator==(const match& lhs, const match& rhs) -> bool = default;
+		};
+
+		// Constructors: empty patterns never match
+		aho_corasick(std::initializer_list<std::string_view> patterns);
+		template<std::ranges::input_range Patterns>
+		requires std::convertible_to<std::ranges::range_reference_t<Patterns>, std::string_view>
+		explicit aho_corasick(const Patterns& patterns);
+
+		// Member Functions
+		auto pattern_count() const noexcept -> std::size_t;
+		auto state_count() const noexcept -> std::size_t;
+		// Calls back with each match in order of its end; a callback that returns bool stops by returning false
+		template<typename Pred, typename Callback>
+		requires std::invocable<Callback&, match>
+		void for_each_match(const basic_filtered_string_view<Pred>& fsv, Callback callback) const;
+		template<typename Pred>
+		auto find_all(const basic_filtered_string_view<Pred>& fsv) const -> std::vector<match>;
+		template<typename Pred>
+		auto contains_any(const basic_filtered_string_view<Pred>& fsv) const -> bool;
+
+	 private:
+		static constexpr std::uint32_t has_output = std::uint32_t{1} << 31;
+		static constexpr std::uint32_t row_mask = has_output - 1;
+		static constexpr std::uint32_t no_pattern = std::numeric_limits<std::uint32_t>::max();
+
+		std::array<std::uint16_t, 256> _class;
+		std::uint32_t _classes;
+		std::vector<std::uint32_t> _next;
+		// Per state: the first pattern ending there, and the nearest proper suffix state that ends one
+		std::vector<std::uint32_t> _output;
+		std::vector<std::uint32_t> _dict;
+		// Per pattern: its length, and the next pattern with the same text
+		std::vector<std::size_t> _lengths;
+		std::vector<std::uint32_t> _same;
+
+		void build(const std::vector<std::string_view>& patterns);
+		template<typename Callback>
+		auto report(std::uint32_t state, std::size_t end, Callback& callback) const -> bool;
+	};
+
+	// Range Constructor
+	template<std::ranges::input_range Patterns>
+	requires std::convertible_to<std::ranges::range_reference_t<Patterns>, std::string_view>
+	aho_corasick::aho_corasick(const Patterns& patterns)
+	: _class()
+	, _classes(0) {
+		auto views = std::vector<std::string_view>();
+		for (const auto& pattern : patterns) {
+			views.emplace_back(pattern);
+		}
+		build(views);
+	}
+
+	// for_each_match Member Function
+	template<typename Pred, typename Callback>
+	requires std::invocable<Callback&, aho_corasick::match>
+	void aho_corasick::for_each_match(const basic_filtered_string_view<Pred>& fsv, Callback callback) const {
+		auto row = std::uint32_t{0};
+		auto end = std::size_t{0};
+		fsv.for_each_run([this, &row, &end, &callback](std::string_view run) {
+			for (const char c : run) {
+				const auto entry = _next[row + _class[static_cast<unsigned char>(c)]];
+				row = entry & row_mask;
+				++end;
+				if ((entry & has_output) != 0 && !report(row / _classes, end, callback)) {
+					return false;
+				}
+			}
+			return true;
+		});
+	}
+
+	// find_all Member Function
+	template<typename Pred>
+	auto aho_corasick::find_all(const basic_filtered_string_view<Pred>& fsv) const -> std::vector<match> {
+		auto result = std::vector<match>();
+		for_each_match(fsv, [&result](match m) { result.push_back(m); });
+		return result;
+	}
+
+	// contains_any Member Function: stops at the first match
+	template<typename Pred>
+	auto aho_corasick::contains_any(const basic_filtered_string_view<Pred>& fsv) const -> bool {
+		auto found = false;
+		for_each_match(fsv, [&found](match) {
+			found = true;
+			return false;
+		});
+		return found;
+	}
+
+	// Report Every Pattern Ending at a State, following the dictionary suffix links
+	template<typename Callback>
+	auto aho_corasick::report(std::uint32_t state, std::size_t end, Callback& callback) const -> bool {
+		for (; state != 0; state = _dict[state]) {
+			for (auto pattern = _output[state]; pattern != no_pattern; pattern = _same[pattern]) {
+				const auto found = match{pattern, end - _lengths[pattern]};
+				if constexpr (std::same_as<std::invoke_result_t<Callback&, match>, bool>) {
+					if (!callback(found)) {
+						return false;
+					}
+				}
+				else {
+					callback(found);
+				}
+			}
+		}
+		return true;
+	}
+} // namespace fsv
+
+#endif // COMP6771_ASS2_AHO_CORASICK_H
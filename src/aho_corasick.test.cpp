@@ -0,0 +1,84 @@
+#include "./aho_corasick.h"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	using match = fsv::aho_corasick::match;
+
+	// Every occurrence of every pattern in text, ordered by end position as the automaton reports them
+	auto naive_matches(const std::vector<std::string>& patterns, const std::string& text) -> std::vector<match> {
+		auto result = std::vector<match>();
+		for (std::size_t p = 0; p < patterns.size(); ++p) {
+			if (patterns[p].empty()) {
+				continue;
+			}
+			for (auto pos = text.find(patterns[p]); pos != std::string::npos; pos = text.find(patterns[p], pos + 1)) {
+				result.push_back(match{p, pos});
+			}
+		}
+		const auto end = [&patterns](const match& m) { return m.index + patterns[m.pattern].size(); };
+		std::sort(result.begin(), result.end(), [&end](const match& lhs, const match& rhs) {
+			return std::pair(end(lhs), lhs.pattern) < std::pair(end(rhs), rhs.pattern);
+		});
+		return result;
+	}
+
+	auto sorted(std::vector<match> matches, const std::vector<std::string>& patterns) -> std::vector<match> {
+		std::sort(matches.begin(), matches.end(), [&patterns](const match& lhs, const match& rhs) {
+			const auto lhs_end = lhs.index + patterns[lhs.pattern].size();
+			const auto rhs_end = rhs.index + patterns[rhs.pattern].size();
+			return std::pair(lhs_end, lhs.pattern) < std::pair(rhs_end, rhs.pattern);
+		});
+		return matches;
+	}
+} // namespace
+
+TEST_CASE("Overlapping Keywords") {
+	const auto matcher = fsv::aho_corasick{"he", "she", "his", "hers"};
+	REQUIRE(matcher.pattern_count() == 4);
+
+	const auto matches = matcher.find_all(fsv::filtered_string_view{"ushers"});
+	REQUIRE(matches == std::vector<match>{{1, 1}, {0, 2}, {3, 2}});
+
+	REQUIRE(matcher.contains_any(fsv::filtered_string_view{"this"}));
+	REQUIRE(!matcher.contains_any(fsv::filtered_string_view{"xyz"}));
+}
+
+TEST_CASE("Matches Span Rejected Characters") {
+	const auto matcher = fsv::aho_corasick{"abc", "", "bc", "bc"};
+	auto sv = fsv::filtered_string_view{"a-b-c-abc", fsv::char_set{"abc"}};
+	REQUIRE(matcher.find_all(sv) == std::vector<match>{{0, 0}, {2, 1}, {3, 1}, {0, 3}, {2, 4}, {3, 4}});
+
+	auto first = std::vector<match>();
+	matcher.for_each_match(sv, [&first](match m) {
+		first.push_back(m);
+		return first.size() < 2;
+	});
+	REQUIRE(first.size() == 2);
+}
+
+TEST_CASE("aho_corasick Matches Repeated find") {
+	auto gen = std::mt19937(6771);
+	for (const int alphabet : {2, 4, 26}) {
+		auto letter = std::uniform_int_distribution<int>(0, alphabet - 1);
+		auto random_string = [&](std::size_t n) {
+			auto s = std::string(n, ' ');
+			for (auto& c : s) {
+				c = static_cast<char>('a' + letter(gen));
+			}
+			return s;
+		};
+		auto patterns = std::vector<std::string>();
+		auto length = std::uniform_int_distribution<std::size_t>(1, 6);
+		for (int i = 0; i < 50; ++i) {
+			patterns.push_back(random_string(length(gen)));
+		}
+		const auto text = random_string(3000);
+		const auto matcher = fsv::aho_corasick(patterns);
+		REQUIRE(sorted(matcher.find_all(fsv::filtered_string_view{text}), patterns) == naive_matches(patterns, text));
+	}
+}
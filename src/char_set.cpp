@@ -0,0 +1,429 @@
+#include "./char_set.h"
+#include "./isa.h"
+
+#include <array>
+#include <bit>
+
+#if defined(FSV_X86_SIMD)
+#	include <immintrin.h>
+#endif
+
+namespace fsv::detail {
+	namespace {
+		// Scalar Kernels (also used for the tails the vector loops leave behind)
+		template<bool Member>
+		auto find_scalar(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+			for (; first != last; ++first) {
+				if (set.contains(*first) == Member) {
+					return first;
+				}
+			}
+			return last;
+		}
+
+		auto count_scalar(const char* first, const char* last, const char_set& set) noexcept -> std::size_t {
+			std::size_t result = 0;
+			for (; first != last; ++first) {
+				result += set.contains(*first) ? 1U : 0U;
+			}
+			return result;
+		}
+
+		auto find_last_scalar(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+			for (const char* p = last; p != first;) {
+				--p;
+				if (set.contains(*p)) {
+					return p;
+				}
+			}
+			return last;
+		}
+
+		auto compress_scalar(const char* first, const char* last, const char_set& set, char* out) noexcept
+		    -> std::size_t {
+			std::size_t n = 0;
+			for (; first != last; ++first) {
+				out[n] = *first;
+				n += set.contains(*first) ? 1U : 0U;
+			}
+			return n;
+		}
+
+		// Block Drivers
+		// Lookup::mask(p) returns bit i set iff p[i] is in the set, for Lookup::width bytes starting at p.
+		template<typename Lookup>
+		auto count_blocks(const char* first, const char* last, const char_set& set) noexcept -> std::size_t {
+			const auto lookup = Lookup(set);
+			std::size_t result = 0;
+			for (; last - first >= Lookup::width; first += Lookup::width) {
+				result += static_cast<std::size_t>(std::popcount(lookup.mask(first)));
+			}
+			return result + count_scalar(first, last, set);
+		}
+
+		template<typename Lookup, bool Member>
+		auto find_blocks(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+			const auto lookup = Lookup(set);
+			for (; last - first >= Lookup::width; first += Lookup::width) {
+				auto mask = lookup.mask(first);
+				if constexpr (!Member) {
+					mask = ~mask & Lookup::full;
+				}
+				if (mask != 0) {
+					return first + std::countr_zero(mask);
+				}
+			}
+			return find_scalar<Member>(first, last, set);
+		}
+
+		template<typename Lookup>
+		auto find_last_blocks(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+			const auto lookup = Lookup(set);
+			const char* p = last;
+			while (p - first >= Lookup::width) {
+				p -= Lookup::width;
+				const auto mask = lookup.mask(p);
+				if (mask != 0) {
+					return p + (static_cast<std::ptrdiff_t>(std::bit_width(mask)) - 1);
+				}
+			}
+			const char* found = find_last_scalar(first, p, set);
+			return found == p ? last : found;
+		}
+
+		// Lookup::pack(p, mask, out) left-packs the masked bytes of one block to out and returns how many it
+		// kept. It may store a whole block; out + n never passes first, so that stays inside a buffer the
+		// size of the input.
+		template<typename Lookup>
+		auto compress_blocks(const char* first, const char* last, const char_set& set, char* out) noexcept
+		    -> std::size_t {
+			const auto lookup = Lookup(set);
+			std::size_t n = 0;
+			for (; last - first >= Lookup::width; first += Lookup::width) {
+				n += lookup.pack(first, lookup.mask(first), out + n);
+			}
+			return n + compress_scalar(first, last, set, out + n);
+		}
+
+#if defined(FSV_X86_SIMD)
+		// pshufb controls that left-pack the selected bytes of an 8-byte group, indexed by the group's mask
+		constexpr auto pack_shuffles = [] {
+			auto table = std::array<std::array<std::uint8_t, 8>, 256>{};
+			for (std::size_t mask = 0; mask < table.size(); ++mask) {
+				std::size_t n = 0;
+				for (std::uint8_t i = 0; i < 8; ++i) {
+					if (((mask >> i) & 1) != 0) {
+						table[mask][n++] = i;
+					}
+				}
+			}
+			return table;
+		}();
+
+		template<int Groups>
+		__attribute__((target("ssse3"))) auto pack_groups(const char* p, std::uint32_t mask, char* out) noexcept
+		    -> std::size_t {
+			std::size_t n = 0;
+			for (int group = 0; group < Groups; ++group) {
+				const auto bits = (mask >> (8 * group)) & 0xFF;
+				const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + 8 * group));
+				const __m128i control = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pack_shuffles[bits].data()));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(out + n), _mm_shuffle_epi8(bytes, control));
+				n += static_cast<std::size_t>(std::popcount(bits));
+			}
+			return n;
+		}
+
+		// pshufb nibble lookup: the low nibble picks a table row, the high nibble picks the bit in that row
+		// (rows 0-7 from the first half of the table, 8-15 from the second).
+		struct ssse3_lookup {
+			static constexpr std::ptrdiff_t width = 16;
+			static constexpr std::uint32_t full = 0xFFFF;
+
+			__attribute__((target("ssse3"))) explicit ssse3_lookup(const char_set& set) noexcept
+			: low_rows(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.table().data())))
+			, high_rows(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.table().data() + 16)))
+			, low_bits(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0))
+			, high_bits(_mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128))
+			, nibble(_mm_set1_epi8(0x0F)) {}
+
+			__attribute__((target("ssse3"))) auto mask(const char* p) const noexcept -> std::uint32_t {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				const __m128i lo = _mm_and_si128(v, nibble);
+				const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+				const __m128i low = _mm_and_si128(_mm_shuffle_epi8(low_rows, lo), _mm_shuffle_epi8(low_bits, hi));
+				const __m128i high = _mm_and_si128(_mm_shuffle_epi8(high_rows, lo), _mm_shuffle_epi8(high_bits, hi));
+				const __m128i rejected = _mm_cmpeq_epi8(_mm_or_si128(low, high), _mm_setzero_si128());
+				return ~static_cast<std::uint32_t>(_mm_movemask_epi8(rejected)) & full;
+			}
+
+			__attribute__((target("ssse3"))) auto pack(const char* p, std::uint32_t mask, char* out) const noexcept
+			    -> std::size_t {
+				return pack_groups<2>(p, mask, out);
+			}
+
+			__m128i low_rows;
+			__m128i high_rows;
+			__m128i low_bits;
+			__m128i high_bits;
+			__m128i nibble;
+		};
+
+		struct avx2_lookup {
+			static constexpr std::ptrdiff_t width = 32;
+			static constexpr std::uint32_t full = 0xFFFFFFFF;
+
+			__attribute__((target("avx2"))) explicit avx2_lookup(const char_set& set) noexcept
+			: low_rows(
+			      _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.table().data()))))
+			, high_rows(_mm256_broadcastsi128_si256(
+			      _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.table().data() + 16))))
+			, low_bits(_mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0)))
+			, high_bits(
+			      _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128)))
+			, nibble(_mm256_set1_epi8(0x0F)) {}
+
+			__attribute__((target("avx2"))) auto mask(const char* p) const noexcept -> std::uint32_t {
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				const __m256i lo = _mm256_and_si256(v, nibble);
+				const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+				const __m256i low =
+				    _mm256_and_si256(_mm256_shuffle_epi8(low_rows, lo), _mm256_shuffle_epi8(low_bits, hi));
+				const __m256i high =
+				    _mm256_and_si256(_mm256_shuffle_epi8(high_rows, lo), _mm256_shuffle_epi8(high_bits, hi));
+				const __m256i rejected = _mm256_cmpeq_epi8(_mm256_or_si256(low, high), _mm256_setzero_si256());
+				return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(rejected));
+			}
+
+			__attribute__((target("avx2"))) auto pack(const char* p, std::uint32_t mask, char* out) const noexcept
+			    -> std::size_t {
+				return pack_groups<4>(p, mask, out);
+			}
+
+			__m256i low_rows;
+			__m256i high_rows;
+			__m256i low_bits;
+			__m256i high_bits;
+			__m256i nibble;
+		};
+
+		// The zero-masked broadcast sidesteps a GCC -Wuninitialized false positive in _mm512_broadcast_i32x4
+		__attribute__((target("avx512f"))) auto broadcast_lanes(__m128i lane) noexcept -> __m512i {
+			return _mm512_maskz_broadcast_i32x4(static_cast<__mmask16>(0xFFFF), lane);
+		}
+
+		// Same lookup over 64 bytes; VBMI2 vpcompressb does the left-packing in one instruction
+		struct avx512_lookup {
+			static constexpr std::ptrdiff_t width = 64;
+
+			__attribute__((target("avx512f,avx512bw"))) explicit avx512_lookup(const char_set& set) noexcept
+			: low_rows(broadcast_lanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.table().data()))))
+			, high_rows(
+			      broadcast_lanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.table().data() + 16))))
+			, low_bits(broadcast_lanes(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0)))
+			, high_bits(broadcast_lanes(_mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128)))
+			, nibble(_mm512_set1_epi8(0x0F)) {}
+
+			__attribute__((target("avx512f,avx512bw"))) auto mask(const char* p) const noexcept -> std::uint64_t {
+				const __m512i v = _mm512_loadu_si512(p);
+				const __m512i lo = _mm512_and_si512(v, nibble);
+				const __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), nibble);
+				const __m512i low =
+				    _mm512_and_si512(_mm512_shuffle_epi8(low_rows, lo), _mm512_shuffle_epi8(low_bits, hi));
+				const __m512i high =
+				    _mm512_and_si512(_mm512_shuffle_epi8(high_rows, lo), _mm512_shuffle_epi8(high_bits, hi));
+				const __m512i hits = _mm512_or_si512(low, high);
+				return _mm512_test_epi8_mask(hits, hits);
+			}
+
+			__attribute__((target("avx512f,avx512bw,avx512vbmi2,popcnt"))) auto
+			pack(const char* p, std::uint64_t mask, char* out) const noexcept -> std::size_t {
+				_mm512_storeu_si512(out, _mm512_maskz_compress_epi8(mask, _mm512_loadu_si512(p)));
+				return static_cast<std::size_t>(std::popcount(mask));
+			}
+
+			__m512i low_rows;
+			__m512i high_rows;
+			__m512i low_bits;
+			__m512i high_bits;
+			__m512i nibble;
+		};
+
+		// flatten lets the block drivers and mask() inline into the ISA-specific entry points
+#	define FSV_SIMD_ENTRY(isa) __attribute__((target(isa), flatten))
+
+		FSV_SIMD_ENTRY("ssse3")
+		auto count_ssse3(const char* first, const char* last, const char_set& set) noexcept -> std::size_t {
+			return count_blocks<ssse3_lookup>(first, last, set);
+		}
+
+		FSV_SIMD_ENTRY("avx2,popcnt")
+		auto count_avx2(const char* first, const char* last, const char_set& set) noexcept -> std::size_t {
+			return count_blocks<avx2_lookup>(first, last, set);
+		}
+
+		template<bool Member>
+		FSV_SIMD_ENTRY("ssse3")
+		auto find_ssse3(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+			return find_blocks<ssse3_lookup, Member>(first, last, set);
+		}
+
+		template<bool Member>
+		FSV_SIMD_ENTRY("avx2,popcnt")
+		auto find_avx2(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+			return find_blocks<avx2_lookup, Member>(first, last, set);
+		}
+
+		FSV_SIMD_ENTRY("ssse3")
+		auto find_last_ssse3(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+			return find_last_blocks<ssse3_lookup>(first, last, set);
+		}
+
+		FSV_SIMD_ENTRY("avx2,popcnt")
+		auto find_last_avx2(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+			return find_last_blocks<avx2_lookup>(first, last, set);
+		}
+
+		FSV_SIMD_ENTRY("ssse3")
+		auto compress_ssse3(const char* first, const char* last, const char_set& set, char* out) noexcept
+		    -> std::size_t {
+			return compress_blocks<ssse3_lookup>(first, last, set, out);
+		}
+
+		FSV_SIMD_ENTRY("avx2,popcnt")
+		auto compress_avx2(const char* first, const char* last, const char_set& set, char* out) noexcept
+		    -> std::size_t {
+			return compress_blocks<avx2_lookup>(first, last, set, out);
+		}
+
+		FSV_SIMD_ENTRY("avx512f,avx512bw,avx512vbmi2,popcnt")
+		auto compress_avx512(const char* first, const char* last, const char_set& set, char* out) noexcept
+		    -> std::size_t {
+			return compress_blocks<avx512_lookup>(first, last, set, out);
+		}
+
+#	undef FSV_SIMD_ENTRY
+#endif
+
+#if defined(FSV_X86_SIMD)
+		// Views shorter than one SSE block are not worth loading the lookup tables for
+		constexpr std::ptrdiff_t min_vector_length = 16;
+
+		template<bool Member>
+		auto find_dispatch(const char* first, const char* last, const char_set& set, isa level) noexcept
+		    -> const char* {
+			if (last - first >= min_vector_length) {
+				switch (level) {
+				case isa::avx512:
+				case isa::avx2: return find_avx2<Member>(first, last, set);
+				case isa::ssse3: return find_ssse3<Member>(first, last, set);
+				case isa::scalar: break;
+				}
+			}
+			return find_scalar<Member>(first, last, set);
+		}
+#endif
+	} // namespace
+
+#if defined(FSV_X86_SIMD)
+	// count Kernel
+	auto count(const char* first, const char* last, const char_set& set) noexcept -> std::size_t {
+		return count(first, last, set, detect_isa());
+	}
+
+	// find Kernel
+	auto find(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+		return find_dispatch<true>(first, last, set, detect_isa());
+	}
+
+	// find_not Kernel
+	auto find_not(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+		return find_dispatch<false>(first, last, set, detect_isa());
+	}
+
+	// find_last Kernel
+	auto find_last(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+		return find_last(first, last, set, detect_isa());
+	}
+
+	// compress Kernel
+	auto compress(const char* first, const char* last, const char_set& set, char* out) noexcept -> std::size_t {
+		return compress(first, last, set, out, detect_isa());
+	}
+
+	// count Kernel for a Given ISA
+	auto count(const char* first, const char* last, const char_set& set, isa level) noexcept -> std::size_t {
+		if (last - first >= min_vector_length) {
+			switch (level) {
+			case isa::avx512:
+			case isa::avx2: return count_avx2(first, last, set);
+			case isa::ssse3: return count_ssse3(first, last, set);
+			case isa::scalar: break;
+			}
+		}
+		return count_scalar(first, last, set);
+	}
+
+	// find Kernel for a Given ISA
+	auto find(const char* first, const char* last, const char_set& set, isa level) noexcept -> const char* {
+		return find_dispatch<true>(first, last, set, level);
+	}
+
+	// find_not Kernel for a Given ISA
+	auto find_not(const char* first, const char* last, const char_set& set, isa level) noexcept -> const char* {
+		return find_dispatch<false>(first, last, set, level);
+	}
+
+	// find_last Kernel for a Given ISA
+	auto find_last(const char* first, const char* last, const char_set& set, isa level) noexcept -> const char* {
+		if (last - first >= min_vector_length) {
+			switch (level) {
+			case isa::avx512:
+			case isa::avx2: return find_last_avx2(first, last, set);
+			case isa::ssse3: return find_last_ssse3(first, last, set);
+			case isa::scalar: break;
+			}
+		}
+		return find_last_scalar(first, last, set);
+	}
+
+	// compress Kernel for a Given ISA
+	auto compress(const char* first, const char* last, const char_set& set, char* out, isa level) noexcept
+	    -> std::size_t {
+		if (last - first >= min_vector_length) {
+			switch (level) {
+			case isa::avx512: return compress_avx512(first, last, set, out);
+			case isa::avx2: return compress_avx2(first, last, set, out);
+			case isa::ssse3: return compress_ssse3(first, last, set, out);
+			case isa::scalar: break;
+			}
+		}
+		return compress_scalar(first, last, set, out);
+	}
+#else
+	// count Kernel
+	auto count(const char* first, const char* last, const char_set& set) noexcept -> std::size_t {
+		return count_scalar(first, last, set);
+	}
+
+	// find Kernel
+	auto find(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+		return find_scalar<true>(first, last, set);
+	}
+
+	// find_not Kernel
+	auto find_not(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+		return find_scalar<false>(first, last, set);
+	}
+
+	// find_last Kernel
+	auto find_last(const char* first, const char* last, const char_set& set) noexcept -> const char* {
+		return find_last_scalar(first, last, set);
+	}
+
+	// compress Kernel
+	auto compress(const char* first, const char* last, const char_set& set, char* out) noexcept -> std::size_t {
+		return compress_scalar(first, last, set, out);
+	}
+#endif
+} // namespace fsv::detail
@@ -0,0 +1,179 @@
+#ifndef COMP6771_ASS2_CHAR_SET_H
+#define COMP6771_ASS2_CHAR_SET_H
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "./isa.h"
+
+namespace fsv {
+	// A 256-bit byte membership table usable as a filter predicate.
+	//
+	// Bytes are stored in nibble-lookup order: byte b lives in _table[(b >> 7) * 16 + (b & 15)] at bit
+	// (b >> 4) & 7. The two 16-byte halves are exactly the shuffle tables the SIMD kernels feed to pshufb,
+	// so a view filtered by a char_set never calls a closure per byte.
+	class char_set {
+	 public:
+		// Constructors
+		constexpr char_set() noexcept = default;
+		explicit constexpr char_set(std::string_view chars) noexcept;
+		template<typename Pred>
+		requires(!std::same_as<std::remove_cvref_t<Pred>, char_set>) && std::predicate<const Pred&, const char&>
+		explicit constexpr char_set(const Pred& pred);
+
+		// Member Operators
+		constexpr auto operator()(const char& c) const noexcept -> bool;
+		constexpr auto operator~() const noexcept -> char_set;
+		constexpr auto operator|=(const char_set& other) noexcept -> char_set&;
+		constexpr auto operator&=(const char_set& other) noexcept -> char_set&;
+
+		// Member Functions
+		constexpr auto contains(char c) const noexcept -> bool;
+		constexpr auto insert(char c) noexcept -> char_set&;
+		constexpr auto erase(char c) noexcept -> char_set&;
+		constexpr auto count() const noexcept -> std::size_t;
+		constexpr auto table() const noexcept -> const std::array<std::uint8_t, 32>&;
+
+		// Non-Member Operators
+		friend constexpr auto operator|(char_set lhs, const char_set& rhs) noexcept -> char_set {
+			return lhs |= rhs;
+		}
+
+		friend constexpr auto operator&(char_set lhs, const char_set& rhs) noexcept -> char_set {
+			return lhs &= rhs;
+		}
+
+		friend constexpr auto operator==(const char_set& lhs, const char_set& rhs) noexcept -> bool = default;
+
+	 private:
+		std::array<std::uint8_t, 32> _table{};
+
+		static constexpr auto slot(char c) noexcept -> std::size_t;
+		static constexpr auto bit(char c) noexcept -> std::uint8_t;
+	};
+
+	// String Constructor
+	constexpr char_set::char_set(std::string_view chars) noexcept {
+		for (const char c : chars) {
+			insert(c);
+		}
+	}
+
+	// Predicate Constructor
+	template<typename Pred>
+	requires(!std::same_as<std::remove_cvref_t<Pred>, char_set>) && std::predicate<const Pred&, const char&>
+	constexpr char_set::char_set(const Pred& pred) {
+		for (int b = 0; b < 256; ++b) {
+			const auto c = static_cast<char>(b);
+			if (pred(c)) {
+				insert(c);
+			}
+		}
+	}
+
+	// Call Operator
+	constexpr auto char_set::operator()(const char& c) const noexcept -> bool {
+		return contains(c);
+	}
+
+	// Complement Operator
+	constexpr auto char_set::operator~() const noexcept -> char_set {
+		auto result = *this;
+		for (auto& byte : result._table) {
+			byte = static_cast<std::uint8_t>(~byte);
+		}
+		return result;
+	}
+
+	// Union Assignment Operator
+	constexpr auto char_set::operator|=(const char_set& other) noexcept -> char_set& {
+		for (std::size_t i = 0; i < _table.size(); ++i) {
+			_table[i] |= other._table[i];
+		}
+		return *this;
+	}
+
+	// Intersection Assignment Operator
+	constexpr auto char_set::operator&=(const char_set& other) noexcept -> char_set& {
+		for (std::size_t i = 0; i < _table.size(); ++i) {
+			_table[i] &= other._table[i];
+		}
+		return *this;
+	}
+
+	// contains Member Function
+	constexpr auto char_set::contains(char c) const noexcept -> bool {
+		return (_table[slot(c)] & bit(c)) != 0;
+	}
+
+	// insert Member Function
+	constexpr auto char_set::insert(char c) noexcept -> char_set& {
+		_table[slot(c)] |= bit(c);
+		return *this;
+	}
+
+	// erase Member Function
+	constexpr auto char_set::erase(char c) noexcept -> char_set& {
+		_table[slot(c)] &= static_cast<std::uint8_t>(~bit(c));
+		return *this;
+	}
+
+	// count Member Function
+	constexpr auto char_set::count() const noexcept -> std::size_t {
+		std::size_t result = 0;
+		for (auto byte : _table) {
+			for (; byte != 0; byte &= static_cast<std::uint8_t>(byte - 1)) {
+				++result;
+			}
+		}
+		return result;
+	}
+
+	// table Member Function
+	constexpr auto char_set::table() const noexcept -> const std::array<std::uint8_t, 32>& {
+		return _table;
+	}
+
+	// Table Slot of a Byte
+	constexpr auto char_set::slot(char c) noexcept -> std::size_t {
+		const auto u = static_cast<unsigned char>(c);
+		return static_cast<std::size_t>(((u >> 7) << 4) | (u & 15));
+	}
+
+	// Bit of a Byte within its Slot
+	constexpr auto char_set::bit(char c) noexcept -> std::uint8_t {
+		const auto u = static_cast<unsigned char>(c);
+		return static_cast<std::uint8_t>(1 << ((u >> 4) & 7));
+	}
+
+	namespace detail {
+		// Table-lookup scanning kernels over [first, last). AVX2 or SSSE3 (AVX-512 VBMI2 for compress) is
+		// picked at runtime when the CPU has it, with a scalar table loop otherwise. The find functions
+		// return last when nothing matches.
+		auto count(const char* first, const char* last, const char_set& set) noexcept -> std::size_t;
+		auto find(const char* first, const char* last, const char_set& set) noexcept -> const char*;
+		auto find_not(const char* first, const char* last, const char_set& set) noexcept -> const char*;
+		auto find_last(const char* first, const char* last, const char_set& set) noexcept -> const char*;
+		// Left-packs the members of [first, last) into out and returns how many were written. out must have
+		// room for last - first bytes: vector stores may fill it beyond the returned count.
+		auto compress(const char* first, const char* last, const char_set& set, char* out) noexcept -> std::size_t;
+
+#if defined(FSV_X86_SIMD)
+		// The same kernels pinned to one instruction set, which the CPU must support (no wider than
+		// detect_isa()), so that every vector path can be checked on one machine
+		auto count(const char* first, const char* last, const char_set& set, isa level) noexcept -> std::size_t;
+		auto find(const char* first, const char* last, const char_set& set, isa level) noexcept -> const char*;
+		auto find_not(const char* first, const char* last, const char_set& set, isa level) noexcept -> const char*;
+		auto find_last(const char* first, const char* last, const char_set& set, isa level) noexcept -> const char*;
+		auto compress(const char* first, const char* last, const char_set& set, char* out, isa level) noexcept
+		    -> std::size_t;
+#endif
+	} // namespace detail
+
+} // namespace fsv
+
+#endif // COMP6771_ASS2_CHAR_SET_H
@@ -0,0 +1,216 @@
+#include "./char_set.h"
+#include "./filtered_string_view.h"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+
+namespace {
+	// Random bytes covering every value, long enough to exercise vector blocks and scalar tails
+	auto random_bytes(std::size_t n, unsigned seed) -> std::string {
+		auto gen = std::mt19937(seed);
+		auto dist = std::uniform_int_distribution<int>(0, 255);
+		auto result = std::string(n, '\0');
+		for (auto& c : result) {
+			c = static_cast<char>(dist(gen));
+		}
+		return result;
+	}
+
+	// The scanning kernels pinned to one instruction set, or the dispatching ones where there is no choice
+	struct kernels {
+#if defined(FSV_X86_SIMD)
+		fsv::detail::isa level;
+
+		auto count(const char* first, const char* last, const fsv::char_set& set) const -> std::size_t {
+			return fsv::detail::count(first, last, set, level);
+		}
+		auto find(const char* first, const char* last, const fsv::char_set& set) const -> const char* {
+			return fsv::detail::find(first, last, set, level);
+		}
+		auto find_not(const char* first, const char* last, const fsv::char_set& set) const -> const char* {
+			return fsv::detail::find_not(first, last, set, level);
+		}
+		auto find_last(const char* first, const char* last, const fsv::char_set& set) const -> const char* {
+			return fsv::detail::find_last(first, last, set, level);
+		}
+		auto compress(const char* first, const char* last, const fsv::char_set& set, char* out) const
+		    -> std::size_t {
+			return fsv::detail::compress(first, last, set, out, level);
+		}
+#else
+		auto count(const char* first, const char* last, const fsv::char_set& set) const -> std::size_t {
+			return fsv::detail::count(first, last, set);
+		}
+		auto find(const char* first, const char* last, const fsv::char_set& set) const -> const char* {
+			return fsv::detail::find(first, last, set);
+		}
+		auto find_not(const char* first, const char* last, const fsv::char_set& set) const -> const char* {
+			return fsv::detail::find_not(first, last, set);
+		}
+		auto find_last(const char* first, const char* last, const fsv::char_set& set) const -> const char* {
+			return fsv::detail::find_last(first, last, set);
+		}
+		auto compress(const char* first, const char* last, const fsv::char_set& set, char* out) const
+		    -> std::size_t {
+			return fsv::detail::compress(first, last, set, out);
+		}
+#endif
+	};
+
+	// One set of kernels per instruction set this CPU can run, so every vector path is checked, not just
+	// the one detect_isa() picks
+	auto every_kernel() -> std::vector<kernels> {
+#if defined(FSV_X86_SIMD)
+		using fsv::detail::isa;
+		auto result = std::vector<kernels>();
+		for (const auto level : {isa::scalar, isa::ssse3, isa::avx2, isa::avx512}) {
+			if (level <= fsv::detail::detect_isa()) {
+				result.push_back(kernels{level});
+			}
+		}
+		return result;
+#else
+		return {kernels{}};
+#endif
+	}
+} // namespace
+
+TEST_CASE("char_set Membership") {
+	constexpr auto vowels = fsv::char_set{"aeiou"};
+	STATIC_REQUIRE(vowels.contains('a'));
+	STATIC_REQUIRE(!vowels.contains('b'));
+	STATIC_REQUIRE(vowels.count() == 5);
+
+	auto high = fsv::char_set{[](const char& c) { return static_cast<unsigned char>(c) >= 0x80; }};
+	REQUIRE(high.count() == 128);
+	REQUIRE(high(static_cast<char>(0xFF)));
+	REQUIRE(!high('\x7F'));
+
+	REQUIRE((~vowels).count() == 251);
+	REQUIRE((vowels & fsv::char_set{"abc"}) == fsv::char_set{"a"});
+	REQUIRE((vowels | fsv::char_set{"xyz"}).count() == 8);
+
+	auto set = fsv::char_set{};
+	set.insert('\0').insert('q');
+	REQUIRE(set.contains('\0'));
+	set.erase('q');
+	REQUIRE(set == fsv::char_set{std::string_view("\0", 1)});
+}
+
+TEST_CASE("char_set Kernels Match Scalar Scanning") {
+	const auto sets = std::vector<fsv::char_set>{
+	    fsv::char_set{},
+	    ~fsv::char_set{},
+	    fsv::char_set{"\x01\x80\xFF"},
+	    fsv::char_set{[](const char& c) { return (static_cast<unsigned char>(c) & 3) == 0; }},
+	};
+	const auto data = random_bytes(300, 6771);
+
+	for (const auto& kernel : every_kernel()) {
+#if defined(FSV_X86_SIMD)
+		INFO("isa " << static_cast<int>(kernel.level));
+#endif
+		for (const auto& set : sets) {
+			for (std::size_t offset = 0; offset < 3; ++offset) {
+				for (std::size_t length : {0U, 1U, 15U, 16U, 17U, 31U, 32U, 33U, 64U, 100U, 297U}) {
+					const char* first = data.data() + offset;
+					const char* last = first + length;
+					auto expected_count = static_cast<std::size_t>(std::count_if(first, last, set));
+					REQUIRE(kernel.count(first, last, set) == expected_count);
+					REQUIRE(kernel.find(first, last, set) == std::find_if(first, last, set));
+					REQUIRE(kernel.find_not(first, last, set) == std::find_if_not(first, last, set));
+
+					const char* expected_last = last;
+					for (const char* p = first; p != last; ++p) {
+						if (set(*p)) {
+							expected_last = p;
+						}
+					}
+					REQUIRE(kernel.find_last(first, last, set) == expected_last);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("char_set as a View Predicate") {
+	const auto text = std::string{"The quick brown fox jumps over the lazy dog, 1234567890 times!"};
+	const auto not_space = ~fsv::char_set{" "};
+
+	auto typed = fsv::basic_filtered_string_view{text, not_space};
+	REQUIRE(typed.size() == 52);
+	REQUIRE(static_cast<std::string>(typed) == "Thequickbrownfoxjumpsoverthelazydog,1234567890times!");
+
+	auto erased = fsv::filtered_string_view{text, not_space};
+	REQUIRE(erased.size() == typed.size());
+	REQUIRE(std::string(erased.rbegin(), erased.rend()) == "!semit0987654321,godyzalehtrevospmujxofnworbkciuqehT");
+
+	std::ostringstream oss;
+	oss << fsv::filtered_string_view{"a b c", fsv::char_set{"ac"}};
+	REQUIRE(oss.str() == "ac");
+}
+
+TEST_CASE("char_set compress Matches Scalar Filtering") {
+	const auto sets = std::vector<fsv::char_set>{
+	    fsv::char_set{},
+	    ~fsv::char_set{},
+	    fsv::char_set{[](const char& c) { return (static_cast<unsigned char>(c) & 1) == 0; }},
+	    fsv::char_set{[](const char& c) { return static_cast<unsigned char>(c) % 7 == 0; }},
+	};
+	const auto data = random_bytes(400, 2024);
+
+#if defined(FSV_X86_SIMD)
+	if (fsv::detail::detect_isa() < fsv::detail::isa::avx512) {
+		WARN("no AVX-512 VBMI2 on this CPU: the vpcompressb kernel is not exercised");
+	}
+#endif
+	for (const auto& kernel : every_kernel()) {
+#if defined(FSV_X86_SIMD)
+		INFO("isa " << static_cast<int>(kernel.level));
+#endif
+		for (const auto& set : sets) {
+			for (std::size_t offset = 0; offset < 3; ++offset) {
+				for (std::size_t length : {0U, 7U, 16U, 33U, 63U, 64U, 65U, 127U, 128U, 130U, 192U, 397U}) {
+					const char* first = data.data() + offset;
+					auto expected = std::string{};
+					std::copy_if(first, first + length, std::back_inserter(expected), set);
+
+					auto out = std::string(length, '\0');
+					const auto kept = kernel.compress(first, first + length, set, out.data());
+					REQUIRE(kept == expected.size());
+					REQUIRE(out.substr(0, kept) == expected);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("pure Materialises a Predicate into a Table") {
+	auto calls = 0;
+	const auto is_digit = [&calls](const char& c) {
+		++calls;
+		return c >= '0' && c <= '9';
+	};
+	const auto digits = fsv::pure(is_digit);
+	REQUIRE(calls == 256);
+	REQUIRE(digits == fsv::char_set{"0123456789"});
+
+	// The view scans with the table and never calls the lambda again, typed or type-erased
+	const auto text = random_bytes(10000, 6771) + "2024";
+	auto typed = fsv::basic_filtered_string_view{text, digits};
+	auto erased = fsv::filtered_string_view{text, fsv::pure(is_digit)};
+	REQUIRE(calls == 512);
+	REQUIRE(erased.predicate().target<fsv::char_set>() != nullptr);
+	REQUIRE(typed.size() == erased.size());
+	REQUIRE(static_cast<std::string>(typed) == static_cast<std::string>(erased));
+	REQUIRE(erased.ends_with("2024"));
+	REQUIRE(calls == 512);
+
+	// Plugin filters arrive type-erased; one that already wraps a table is not re-evaluated
+	const auto plugin = fsv::filter([](const char& c) { return c == ','; });
+	REQUIRE(fsv::pure(plugin) == fsv::char_set{","});
+	const auto wrapped = fsv::filter(digits);
+	REQUIRE(fsv::pure(wrapped) == digits);
+	STATIC_REQUIRE(fsv::pure([](const char& c) { return c == 'a'; }).count() == 1);
+}
@@ -0,0 +1,393 @@
+#include "./delimiter.h"
+#include "./isa.h"
+
+#include <cstring>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#if defined(FSV_X86_SIMD)
+#	include <immintrin.h>
+#endif
+
+namespace fsv::detail {
+	namespace {
+		auto byte_mask_scalar(const char* p, const char* last, char c) noexcept -> std::uint64_t {
+			const auto n = std::min<std::ptrdiff_t>(last - p, 64);
+			std::uint64_t mask = 0;
+			for (std::ptrdiff_t i = 0; i < n; ++i) {
+				mask |= static_cast<std::uint64_t>(p[i] == c ? 1U : 0U) << i;
+			}
+			return mask;
+		}
+
+#if defined(FSV_X86_SIMD)
+		// pcmpeqb + pmovmskb over four 16-byte lanes
+		__attribute__((target("sse2"))) auto byte_mask_sse2(const char* p, char c) noexcept -> std::uint64_t {
+			const __m128i needle = _mm_set1_epi8(c);
+			std::uint64_t mask = 0;
+			for (int lane = 0; lane < 4; ++lane) {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * lane));
+				const auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)));
+				mask |= static_cast<std::uint64_t>(bits) << (16 * lane);
+			}
+			return mask;
+		}
+
+		__attribute__((target("avx2"))) auto byte_mask_avx2(const char* p, char c) noexcept -> std::uint64_t {
+			const __m256i needle = _mm256_set1_epi8(c);
+			const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+			const auto low_bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle)));
+			const auto high_bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle)));
+			return (static_cast<std::uint64_t>(high_bits) << 32) | low_bits;
+		}
+#endif
+
+		// Crochemore-Perrin Two-Way matching: the needle is cut at a critical factorisation, the right part
+		// is matched forwards and then the left part backwards, and every mismatch shifts by an amount that
+		// never skips an occurrence. Linear time in constant space whatever the input, periodic included.
+		class two_way {
+		 public:
+			explicit two_way(std::string_view needle) noexcept;
+
+			auto find(const char* first, const char* last) const noexcept -> const char*;
+
+		 private:
+			std::string_view _needle;
+			std::size_t _split = 0;
+			std::size_t _period = 1;
+			// Whether the needle is periodic with _period, so matched periods need not be rescanned
+			bool _periodic = false;
+
+			auto at(std::size_t i) const noexcept -> unsigned char {
+				return static_cast<unsigned char>(_needle[i]);
+			}
+			auto maximal_suffix(bool reversed) const noexcept -> std::pair<std::size_t, std::size_t>;
+		};
+
+		// Start and period of the needle's lexicographically greatest suffix, or its least when reversed
+		auto two_way::maximal_suffix(bool reversed) const noexcept -> std::pair<std::size_t, std::size_t> {
+			std::size_t start = 0;
+			std::size_t candidate = 1;
+			std::size_t offset = 0;
+			std::size_t period = 1;
+			while (candidate + offset < _needle.size()) {
+				const auto a = at(candidate + offset);
+				const auto b = at(start + offset);
+				if (a == b) {
+					if (offset + 1 == period) {
+						candidate += period;
+						offset = 0;
+					}
+					else {
+						++offset;
+					}
+				}
+				else if ((a < b) != reversed) {
+					candidate += offset + 1;
+					offset = 0;
+					period = candidate - start;
+				}
+				else {
+					start = candidate++;
+					offset = 0;
+					period = 1;
+				}
+			}
+			return {start, period};
+		}
+
+		// Two-Way Constructor: the later of the two maximal suffixes is a critical factorisation
+		two_way::two_way(std::string_view needle) noexcept
+		: _needle(needle) {
+			const auto [less_split, less_period] = maximal_suffix(false);
+			const auto [greater_split, greater_period] = maximal_suffix(true);
+			std::tie(_split, _period) = less_split > greater_split ? std::pair(less_split, less_period)
+			                                                       : std::pair(greater_split, greater_period);
+			_periodic = _period + _split <= needle.size()
+			            && needle.substr(0, _split) == needle.substr(_period, _split);
+			if (!_periodic) {
+				_period = std::max(_split, needle.size() - _split) + 1;
+			}
+		}
+
+		// Two-Way find Member Function
+		auto two_way::find(const char* first, const char* last) const noexcept -> const char* {
+			const auto m = _needle.size();
+			const auto n = static_cast<std::size_t>(last - first);
+			std::size_t memory = 0;
+			for (std::size_t pos = 0; n - pos >= m;) {
+				std::size_t i = _periodic ? std::max(_split, memory) : _split;
+				while (i < m && at(i) == static_cast<unsigned char>(first[pos + i])) {
+					++i;
+				}
+				if (i < m) {
+					pos += i - _split + 1;
+					memory = 0;
+					continue;
+				}
+				const std::size_t floor = _periodic ? memory : 0;
+				std::size_t j = _split;
+				while (j > floor && at(j - 1) == static_cast<unsigned char>(first[pos + j - 1])) {
+					--j;
+				}
+				if (j == floor) {
+					return first + pos;
+				}
+				pos += _period;
+				memory = _periodic ? m - _period : 0;
+			}
+			return last;
+		}
+
+		auto search_scalar(const char* first, const char* last, std::string_view needle) -> const char* {
+			return two_way(needle).find(first, last);
+		}
+
+		// The searches no kernel needs to see: an empty needle, a range too short to hold the needle (which
+		// covers a null, empty one, never to reach memchr) and a single byte, which memchr finds
+		auto search_trivial(const char* first, const char* last, std::string_view needle) noexcept
+		    -> std::optional<const char*> {
+			if (needle.empty()) {
+				return first;
+			}
+			if (last - first < static_cast<std::ptrdiff_t>(needle.size())) {
+				return last;
+			}
+			if (needle.size() == 1) {
+				const auto* hit = std::memchr(first, needle.front(), static_cast<std::size_t>(last - first));
+				return hit == nullptr ? last : static_cast<const char*>(hit);
+			}
+			return std::nullopt;
+		}
+
+		// Below this many bytes per chunk, starting a thread costs more than searching the chunk
+		constexpr std::ptrdiff_t min_chunk_length = std::ptrdiff_t{1} << 20;
+
+		// Whether two occurrences of tok can overlap, i.e. some proper prefix is also a suffix
+		auto self_overlapping(std::string_view tok) noexcept -> bool {
+			for (std::size_t k = 1; k < tok.size(); ++k) {
+				if (tok.starts_with(tok.substr(tok.size() - k))) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Occurrences starting in [first, chunk_end), searching no further than last. A self-overlapping
+		// token is collected at every position, since the chunk cannot know which ones the occurrences
+		// before it will swallow; the join drops those.
+		auto chunk_hits(const char* first, const char* chunk_end, const char* last, std::string_view tok)
+		    -> std::vector<const char*> {
+			const char* until = last - chunk_end >= static_cast<std::ptrdiff_t>(tok.size() - 1)
+			                        ? chunk_end + (tok.size() - 1)
+			                        : last;
+			const auto step = self_overlapping(tok) ? std::size_t{1} : tok.size();
+			auto finder = delimiter_finder(tok);
+			auto hits = std::vector<const char*>{};
+			for (const char* p = finder.next(first, until); p != until; p = finder.next(p + step, until)) {
+				hits.push_back(p);
+			}
+			return hits;
+		}
+
+#if defined(FSV_X86_SIMD)
+		// Failed candidates search_blocks puts up with before it starts weighing them against the bytes scanned
+		constexpr std::size_t free_failures = 16;
+
+		// Confirms each candidate in mask (bit i for position p + i) by comparing the needle's inner bytes,
+		// counting the candidates that fail
+		inline auto first_match(const char* p, std::uint32_t mask, std::string_view needle, std::size_t& failures)
+		    -> const char* {
+			for (; mask != 0; mask &= mask - 1) {
+				const char* candidate = p + std::countr_zero(mask);
+				if (std::memcmp(candidate + 1, needle.data() + 1, needle.size() - 2) == 0) {
+					return candidate;
+				}
+				++failures;
+			}
+			return nullptr;
+		}
+
+		// First/last byte filtering over Lanes-wide blocks (needle.size() >= 2); the leftover positions, fewer
+		// than one block, go to std::search. Each failed candidate may cost a compare of the whole needle, so on
+		// periodic input the filter alone is O(n * m): once failures have cost more than a few passes over the
+		// bytes scanned, the rest of the range goes to Two-Way instead.
+		template<typename Lanes>
+		auto search_blocks(const char* first, const char* last, std::string_view needle) noexcept -> const char* {
+			const auto m = static_cast<std::ptrdiff_t>(needle.size());
+			const auto lanes = Lanes(needle.front(), needle.back());
+			std::size_t failures = 0;
+			const char* p = first;
+			for (; last - p >= Lanes::width + m - 1; p += Lanes::width) {
+				const auto mask = lanes.candidates(p, p + m - 1);
+				if (const char* hit = first_match(p, mask, needle, failures); hit != nullptr) {
+					return hit;
+				}
+				const auto scanned = static_cast<std::size_t>(p - first);
+				if (failures > free_failures && (failures - free_failures) * needle.size() > 2 * scanned) {
+					return two_way(needle).find(p + Lanes::width, last);
+				}
+			}
+			return std::search(p, last, needle.begin(), needle.end());
+		}
+
+		struct sse2_lanes {
+			static constexpr std::ptrdiff_t width = 16;
+
+			__attribute__((target("sse2"))) sse2_lanes(char first, char last) noexcept
+			: first_byte(_mm_set1_epi8(first))
+			, last_byte(_mm_set1_epi8(last)) {}
+
+			__attribute__((target("sse2"))) auto candidates(const char* head, const char* tail) const noexcept
+			    -> std::uint32_t {
+				const __m128i heads = _mm_loadu_si128(reinterpret_cast<const __m128i*>(head));
+				const __m128i tails = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail));
+				const __m128i both = _mm_and_si128(_mm_cmpeq_epi8(heads, first_byte), _mm_cmpeq_epi8(tails, last_byte));
+				return static_cast<std::uint32_t>(_mm_movemask_epi8(both));
+			}
+
+			__m128i first_byte;
+			__m128i last_byte;
+		};
+
+		struct avx2_lanes {
+			static constexpr std::ptrdiff_t width = 32;
+
+			__attribute__((target("avx2"))) avx2_lanes(char first, char last) noexcept
+			: first_byte(_mm256_set1_epi8(first))
+			, last_byte(_mm256_set1_epi8(last)) {}
+
+			__attribute__((target("avx2"))) auto candidates(const char* head, const char* tail) const noexcept
+			    -> std::uint32_t {
+				const __m256i heads = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(head));
+				const __m256i tails = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail));
+				const __m256i both =
+				    _mm256_and_si256(_mm256_cmpeq_epi8(heads, first_byte), _mm256_cmpeq_epi8(tails, last_byte));
+				return static_cast<std::uint32_t>(_mm256_movemask_epi8(both));
+			}
+
+			__m256i first_byte;
+			__m256i last_byte;
+		};
+
+		__attribute__((target("sse2"), flatten)) auto
+		search_sse2(const char* first, const char* last, std::string_view needle) noexcept -> const char* {
+			return search_blocks<sse2_lanes>(first, last, needle);
+		}
+
+		__attribute__((target("avx2"), flatten)) auto
+		search_avx2(const char* first, const char* last, std::string_view needle) noexcept -> const char* {
+			return search_blocks<avx2_lanes>(first, last, needle);
+		}
+#endif
+	} // namespace
+
+	// byte_mask Kernel: vector compares for a whole block, scalar for the final partial one
+	auto byte_mask(const char* p, const char* last, char c) noexcept -> std::uint64_t {
+#if defined(FSV_X86_SIMD)
+		if (last - p >= 64) {
+			switch (detect_isa()) {
+			case isa::avx512:
+			case isa::avx2: return byte_mask_avx2(p, c);
+			case isa::ssse3: return byte_mask_sse2(p, c);
+			case isa::scalar: break;
+			}
+		}
+#endif
+		return byte_mask_scalar(p, last, c);
+	}
+
+	// search Kernel
+	auto search(const char* first, const char* last, std::string_view needle) -> const char* {
+#if defined(FSV_X86_SIMD)
+		return search(first, last, needle, detect_isa());
+#else
+		if (const auto hit = search_trivial(first, last, needle)) {
+			return *hit;
+		}
+		return search_scalar(first, last, needle);
+#endif
+	}
+
+#if defined(FSV_X86_SIMD)
+	// search Kernel for a Given ISA
+	auto search(const char* first, const char* last, std::string_view needle, isa level) -> const char* {
+		if (const auto hit = search_trivial(first, last, needle)) {
+			return *hit;
+		}
+		switch (level) {
+		case isa::avx512:
+		case isa::avx2: return search_avx2(first, last, needle);
+		case isa::ssse3: return search_sse2(first, last, needle);
+		case isa::scalar: break;
+		}
+		return search_scalar(first, last, needle);
+	}
+#endif
+
+	// Parallel Delimiter Search
+	auto find_delimiters(const char* first, const char* last, std::string_view tok, std::size_t threads)
+	    -> std::vector<const char*> {
+		if (tok.empty()) {
+			return {};
+		}
+		if (threads == 0) {
+			threads = std::max(1U, std::thread::hardware_concurrency());
+		}
+		const auto length = last - first;
+		const auto chunks = static_cast<std::ptrdiff_t>(std::min<std::size_t>(
+		    threads, static_cast<std::size_t>(std::max<std::ptrdiff_t>(1, length / min_chunk_length))));
+
+		auto hits = std::vector<std::vector<const char*>>(static_cast<std::size_t>(chunks));
+		{
+			auto workers = std::vector<std::jthread>{};
+			workers.reserve(static_cast<std::size_t>(chunks - 1));
+			for (std::ptrdiff_t k = 0; k < chunks; ++k) {
+				const char* chunk_first = first + length * k / chunks;
+				const char* chunk_end = first + length * (k + 1) / chunks;
+				auto& out = hits[static_cast<std::size_t>(k)];
+				auto work = [chunk_first, chunk_end, last, tok, &out] {
+					out = chunk_hits(chunk_first, chunk_end, last, tok);
+				};
+				if (k + 1 < chunks) {
+					workers.emplace_back(work);
+				}
+				else {
+					work();
+				}
+			}
+		}
+
+		auto result = std::vector<const char*>{};
+		const char* allowed = first;
+		for (const auto& chunk : hits) {
+			for (const char* hit : chunk) {
+				if (hit >= allowed) {
+					result.push_back(hit);
+					allowed = hit + tok.size();
+				}
+			}
+		}
+		return result;
+	}
+
+	// Jump to the Next Hit with memchr and Cache the Mask of the Block Starting There
+	auto delimiter_finder::scan(const char* from, const char* last) -> const char* {
+		if (from == last) {
+			_block = nullptr;
+			return last;
+		}
+		const auto length = static_cast<std::size_t>(last - from);
+		const auto* hit = static_cast<const char*>(std::memchr(from, _tok.front(), length));
+		if (hit == nullptr) {
+			_block = nullptr;
+			return last;
+		}
+		_block = hit;
+		_mask = byte_mask(hit, last, _tok.front());
+		return hit;
+	}
+} // namespace fsv::detail
@@ -0,0 +1,82 @@
+#ifndef COMP6771_ASS2_DELIMITER_H
+#define COMP6771_ASS2_DELIMITER_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "./isa.h"
+
+namespace fsv::detail {
+	// Bit i set iff p[i] == c, for the first 64 bytes of [p, last) (fewer when the range is shorter)
+	auto byte_mask(const char* p, const char* last, char c) noexcept -> std::uint64_t;
+
+	// First occurrence of needle in [first, last), or last. Candidates are positions whose first and last
+	// bytes both match, found 32 (AVX2) or 16 (SSE2) at a time and confirmed with memcmp; when too many
+	// candidates fail (periodic input), and always without vector support, Two-Way takes over, so the
+	// search is linear in the worst case. An empty needle matches at first.
+	auto search(const char* first, const char* last, std::string_view needle) -> const char*;
+#if defined(FSV_X86_SIMD)
+	// The same search pinned to one instruction set, which the CPU must support (no wider than detect_isa())
+	auto search(const char* first, const char* last, std::string_view needle, isa level) -> const char*;
+#endif
+
+	// Finds successive occurrences of a raw delimiter in one buffer.
+	//
+	// A one-byte delimiter is located with memchr, and the compare mask of the 64 bytes starting at each
+	// hit is kept: the delimiters that follow within that block are read off the mask with a bit scan
+	// instead of another call. Longer delimiters go to search().
+	class delimiter_finder {
+	 public:
+		// Constructors
+		delimiter_finder() noexcept = default;
+		explicit delimiter_finder(std::string_view tok) noexcept;
+
+		// First occurrence starting in [from, last), or last. from must not decrease between calls.
+		auto next(const char* from, const char* last) -> const char*;
+
+	 private:
+		static constexpr std::ptrdiff_t block_size = 64;
+
+		std::string_view _tok;
+		const char* _block = nullptr;
+		std::uint64_t _mask = 0;
+
+		auto scan(const char* from, const char* last) -> const char*;
+	};
+
+	// Starts of the non-overlapping occurrences of tok in [first, last), leftmost first, exactly as repeated
+	// delimiter_finder::next calls would report them. The range is cut into one chunk per thread, each
+	// chunk searched on its own thread (reading up to tok.size() - 1 bytes past its end so no straddling
+	// occurrence is missed), and the per-chunk hits joined in order. threads == 0 means one per core;
+	// ranges too short to be worth a thread stay on the calling one.
+	auto find_delimiters(const char* first, const char* last, std::string_view tok, std::size_t threads)
+	    -> std::vector<const char*>;
+
+	// Delimiter Constructor
+	inline delimiter_finder::delimiter_finder(std::string_view tok) noexcept
+	: _tok(tok) {}
+
+	// next Member Function: answered from the cached block mask when from falls inside it
+	inline auto delimiter_finder::next(const char* from, const char* last) -> const char* {
+		if (_tok.size() != 1) {
+			return search(from, last, _tok);
+		}
+		if (_block != nullptr && from >= _block && from - _block < block_size) {
+			const auto offset = from - _block;
+			const auto rest = _mask >> offset;
+			if (rest != 0) {
+				return from + std::countr_zero(rest);
+			}
+			if (last - _block <= block_size) {
+				return last;
+			}
+			from = _block + block_size;
+		}
+		return scan(from, last);
+	}
+} // namespace fsv::detail
+
+#endif // COMP6771_ASS2_DELIMITER_H
@@ -0,0 +1,167 @@
+#include "./delimiter.h"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	// Bytes drawn from a small alphabet so that any one of them is a delimiter at a known density
+	auto random_text(std::size_t n, int alphabet, unsigned seed) -> std::string {
+		auto gen = std::mt19937(seed);
+		auto dist = std::uniform_int_distribution<int>(0, alphabet - 1);
+		auto result = std::string(n, '\0');
+		for (auto& c : result) {
+			c = static_cast<char>('a' + dist(gen));
+		}
+		return result;
+	}
+
+	auto all_hits(fsv::detail::delimiter_finder finder, const std::string& text, std::size_t step)
+	    -> std::vector<std::size_t> {
+		auto result = std::vector<std::size_t>{};
+		const char* first = text.data();
+		const char* last = first + text.size();
+		for (const char* p = finder.next(first, last); p != last; p = finder.next(p + step, last)) {
+			result.push_back(static_cast<std::size_t>(p - first));
+		}
+		return result;
+	}
+
+	using search_function = std::function<const char*(const char*, const char*, std::string_view)>;
+
+	// search pinned to each instruction set this CPU can run, so the scalar Two-Way path is checked too
+	auto every_search() -> std::vector<search_function> {
+#if defined(FSV_X86_SIMD)
+		using fsv::detail::isa;
+		auto result = std::vector<search_function>();
+		for (const auto level : {isa::scalar, isa::ssse3, isa::avx2, isa::avx512}) {
+			if (level <= fsv::detail::detect_isa()) {
+				result.emplace_back([level](const char* first, const char* last, std::string_view needle) {
+					return fsv::detail::search(first, last, needle, level);
+				});
+			}
+		}
+		return result;
+#else
+		return {search_function(
+		    [](const char* first, const char* last, std::string_view needle) {
+			    return fsv::detail::search(first, last, needle);
+		    })};
+#endif
+	}
+} // namespace
+
+TEST_CASE("byte_mask Matches a Byte Loop") {
+	const auto text = random_text(200, 4, 6771);
+	for (std::size_t offset = 0; offset < text.size(); ++offset) {
+		const char* p = text.data() + offset;
+		const char* last = text.data() + text.size();
+		auto expected = std::uint64_t{0};
+		for (std::size_t i = 0; i < 64 && offset + i < text.size(); ++i) {
+			expected |= static_cast<std::uint64_t>(p[i] == 'b' ? 1U : 0U) << i;
+		}
+		REQUIRE(fsv::detail::byte_mask(p, last, 'b') == expected);
+	}
+}
+
+TEST_CASE("delimiter_finder Finds Every Occurrence") {
+	for (const int alphabet : {2, 8, 200}) {
+		for (const std::size_t n : {0U, 1U, 63U, 64U, 65U, 1000U}) {
+			const auto text = random_text(n, alphabet, static_cast<unsigned>(n) + 1);
+			for (const std::string tok : {"a", "ab", "aba"}) {
+				auto expected = std::vector<std::size_t>{};
+				for (auto pos = text.find(tok); pos != std::string::npos; pos = text.find(tok, pos + tok.size())) {
+					expected.push_back(pos);
+				}
+				REQUIRE(all_hits(fsv::detail::delimiter_finder(tok), text, tok.size()) == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("search Matches std::string::find") {
+	for (const auto& search : every_search()) {
+		for (const int alphabet : {2, 3, 26}) {
+			const auto text = random_text(700, alphabet, static_cast<unsigned>(alphabet));
+			for (const std::size_t m : {0U, 1U, 2U, 3U, 5U, 17U, 40U}) {
+				for (std::size_t start = 0; start + m <= text.size(); start += 97) {
+					// Needles cut from the text always occur; reversed ones often do not
+					auto needle = text.substr(start, m);
+					for (int variant = 0; variant < 2; ++variant) {
+						for (const std::size_t from : {0U, 1U, 31U, 350U}) {
+							const auto expected = text.find(needle, from);
+							const char* first = text.data() + from;
+							const char* last = text.data() + text.size();
+							const char* hit = search(first, last, needle);
+							const auto found = hit == last && !needle.empty() ? std::string::npos
+							                                                   : std::size_t(hit - text.data());
+							REQUIRE(found == expected);
+						}
+						std::reverse(needle.begin(), needle.end());
+					}
+				}
+			}
+		}
+
+		// An empty range may be a pair of null pointers
+		REQUIRE(search(nullptr, nullptr, "a") == nullptr);
+		REQUIRE(search(nullptr, nullptr, "ab") == nullptr);
+		REQUIRE(search(nullptr, nullptr, "") == nullptr);
+	}
+	REQUIRE(fsv::detail::delimiter_finder(",").next(nullptr, nullptr) == nullptr);
+}
+
+TEST_CASE("search Stays Linear on Periodic Input") {
+	// Every position of a run of 'a's passes the first/last byte filter for a needle of 'a's around one 'b',
+	// and then fails halfway through it: quadratic for the filter alone, linear once Two-Way takes over
+	const auto text = std::string(std::size_t{1} << 22, 'a');
+	for (const auto& search : every_search()) {
+		for (const std::size_t half : {1U, 32U, 2048U}) {
+			const auto needle = std::string(half, 'a') + 'b' + std::string(half, 'a');
+			REQUIRE(search(text.data(), text.data() + text.size(), needle) == text.data() + text.size());
+
+			for (const std::size_t at : {std::size_t{0}, std::size_t{5000}, text.size() - needle.size()}) {
+				auto planted = text;
+				planted[at + half] = 'b';
+				const char* first = planted.data();
+				REQUIRE(search(first, first + planted.size(), needle) == first + at);
+			}
+		}
+	}
+
+	// Periodic needles over a periodic haystack with sparse defects, against std::string::find
+	auto defects = std::string();
+	for (std::size_t i = 0; defects.size() < 20000; ++i) {
+		defects += i % 37 == 0 ? "abaabaab" : "abaabab";
+	}
+	for (const auto& search : every_search()) {
+		for (const std::string needle : {"abaabaab", "abaababaabab", "babaabaababaaba", "aabaabaabaab"}) {
+			for (const std::size_t from : {0U, 3U, 7000U}) {
+				const auto expected = defects.find(needle, from);
+				const char* last = defects.data() + defects.size();
+				const char* hit = search(defects.data() + from, last, needle);
+				REQUIRE((hit == last ? std::string::npos : static_cast<std::size_t>(hit - defects.data())) == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("find_delimiters Agrees with a Sequential Scan") {
+	// Several MiB, so the range really is cut into chunks and occurrences straddle the cuts
+	const auto text = random_text((std::size_t{9} << 19) + 13, 2, 6771);
+	const char* first = text.data();
+	const char* last = first + text.size();
+	for (const std::string tok : {"a", "ab", "aa", "abab", "bbbbbbbbba"}) {
+		auto expected = std::vector<const char*>{};
+		auto finder = fsv::detail::delimiter_finder(tok);
+		for (const char* p = finder.next(first, last); p != last; p = finder.next(p + tok.size(), last)) {
+			expected.push_back(p);
+		}
+		for (const std::size_t threads : {1U, 3U, 4U}) {
+			REQUIRE(fsv::detail::find_delimiters(first, last, tok, threads) == expected);
+		}
+	}
+}
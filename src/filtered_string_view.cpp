@@ -1,380 +1,194 @@
 #include "./filtered_string_view.h"
 #include "filtered_string_view.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <compare>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 namespace fsv {
-	filter filtered_string_view::default_predicate = [](const char&) { return true; };
+	template class basic_filtered_string_view<filter>;
+	template auto split(const filtered_string_view& fsv, const filtered_string_view& tok)
+	    -> std::vector<filtered_string_view>;
+	template auto substr(const filtered_string_view& fsv, int pos, int count) -> filtered_string_view;
 
-	// Default Constructor
-	filtered_string_view::filtered_string_view() noexcept
-	: _ptr(nullptr)
-	, _length(0)
-	, _predicate(default_predicate) {}
+	// Search Buffer Constructor: blocks of at least half the buffer whatever the needle length
+	detail::search_buffer::search_buffer(std::size_t needle_size)
+	: _local()
+	, _heap(needle_size > local_size / 2 ? 2 * needle_size : 0) {}
 
-	// Implicit String Constructor
-	filtered_string_view::filtered_string_view(const std::string& str)
-	: _ptr(str.data())
-	, _length(str.size())
-	, _predicate(default_predicate) {}
-
-	// String Constructor with Predicate
-	filtered_string_view::filtered_string_view(const std::string& str, filter predicate)
-	: _ptr(str.data())
-	, _length(str.size())
-	, _predicate(predicate) {}
-
-	// Implicit Null-Terminated String Constructor
-	filtered_string_view::filtered_string_view(const char* str)
-	: _ptr(str)
-	, _length(std::strlen(str))
-	, _predicate(default_predicate) {}
-
-	// Null-Terminated String with Predicate Constructor
-	filtered_string_view::filtered_string_view(const char* str, filter predicate)
-	: _ptr(str)
-	, _length(std::strlen(str))
-	, _predicate(predicate) {}
-
-	// Copy Constructor
-	filtered_string_view::filtered_string_view(const filtered_string_view& other) noexcept
-	: _ptr(other._ptr)
-	, _length(other._length)
-	, _predicate(other._predicate) {}
-
-	// Move Constructor
-	filtered_string_view::filtered_string_view(filtered_string_view&& other) noexcept
-	: _ptr(other._ptr)
-	, _length(other._length)
-	, _predicate(other._predicate) {
-		other._ptr = nullptr;
-		other._length = 0;
-		other._predicate = default_predicate;
+	// Search Buffer data Member Function
+	auto detail::search_buffer::data() noexcept -> char* {
+		return _heap.empty() ? _local.data() : _heap.data();
 	}
 
-	// Copy Assignment Operator
-	auto filtered_string_view::operator=(const filtered_string_view& other) noexcept -> filtered_string_view& {
-		if (this != &other) {
-			_ptr = other._ptr;
-			_length = other._length;
-			_predicate = other._predicate;
-		}
-		return *this;
+	// Search Buffer size Member Function
+	auto detail::search_buffer::size() const noexcept -> std::size_t {
+		return _heap.empty() ? _local.size() : _heap.size();
 	}
 
-	// Move Assignment Operator
-	auto filtered_string_view::operator=(filtered_string_view&& other) noexcept -> filtered_string_view& {
-		if (this != &other) {
-			_ptr = other._ptr;
-			_length = other._length;
-			_predicate = std::move(other._predicate);
+	// Filter Holder Constructor
+	detail::predicate_holder<filter>::predicate_holder(filter pred)
+	: _word(allocate(std::move(pred))) {}
 
-			other._ptr = nullptr;
-			other._length = 0;
-			other._predicate = default_predicate;
+	// Counted Copy of a Type-Erased Filter: an accept-all one needs none
+	auto detail::predicate_holder<filter>::allocate(filter pred) -> std::uintptr_t {
+		if (pred.target<accept_all>() != nullptr) {
+			return 0;
 		}
-		return *this;
-	}
+		return reinterpret_cast<std::uintptr_t>(new node{std::move(pred), 1});
+	}
+
+	// Shared Accept-All Filter
+	auto detail::accept_all_filter() noexcept -> const filter& {
+		static const auto all = filter(accept_all{});
+		return all;
+	}
+
+	// View Cache build Member Function
+	auto detail::view_cache::build(rank_select index) -> const rank_select& {
+		auto* shared = new shared_index{std::move(index), 1};
+		release(_word.exchange(reinterpret_cast<std::uintptr_t>(shared), std::memory_order_relaxed));
+		return shared->index;
+	}
+
+	namespace {
+		// The AND of runtime-configured filters, tried in the order that rejects a character most cheaply.
+		// Every sample_period-th call to a composed predicate evaluates all of its filters, timing each and
+		// counting which reject; every rerank_period samples the filters are ranked by rejections per
+		// nanosecond, and the counts are halved so the order follows the data as it drifts. While reranking
+		// keeps confirming the order the sample period doubles, up to max_sample_period, and it drops back
+		// when the order changes. All of this lives in the state the predicate's copies share, so each
+		// composition samples at its own rate on any number of threads; the order is one atomic word of
+		// 4-bit filter indices. Chains longer than max_adaptive keep the given order.
+		class adaptive_conjunction {
+		 public:
+			explicit adaptive_conjunction(std::vector<filter> filts);
+
+			auto operator()(const char& c) const -> bool;
+
+		 private:
+			static constexpr std::size_t max_adaptive = 16;
+			static constexpr std::uint32_t min_sample_period = 256;
+			static constexpr std::uint32_t max_sample_period = std::uint32_t{1} << 16;
+			static constexpr std::uint64_t rerank_period = 64;
+
+			struct state {
+				std::vector<filter> filters;
+				std::atomic<std::uint64_t> order;
+				// Calls left until the next sample, kept with relaxed loads and stores rather than
+				// read-modify-writes: a call racing on another thread may repeat or skip a sample, which only
+				// jitters the rate
+				std::atomic<std::uint32_t> countdown;
+				std::atomic<std::uint32_t> sample_period;
+				std::array<std::atomic<std::uint64_t>, max_adaptive> rejections;
+				std::array<std::atomic<std::uint64_t>, max_adaptive> nanoseconds;
+				std::atomic<std::uint64_t> samples;
+			};
+
+			std::shared_ptr<state> _state;
+
+			auto sample(const char& c) const -> bool;
+			void rerank() const;
+		};
 
-	// Subscript Operator
-	auto filtered_string_view::operator[](int n) -> const char& {
-		int index = 0;
-		for (const char* p = _ptr; p != _ptr + _length; ++p) {
-			if (_predicate(*p)) {
-				if (index == n) {
-					return *p;
-				}
-				++index;
+		// Adaptive Conjunction Constructor: the given order to begin with
+		adaptive_conjunction::adaptive_conjunction(std::vector<filter> filts)
+		: _state(std::make_shared<state>()) {
+			_state->filters = std::move(filts);
+			auto order = std::uint64_t{0};
+			for (std::size_t i = 0; i < std::min(_state->filters.size(), max_adaptive); ++i) {
+				order |= std::uint64_t{i} << (4 * i);
 			}
+			_state->order.store(order, std::memory_order_relaxed);
+			_state->countdown.store(min_sample_period, std::memory_order_relaxed);
+			_state->sample_period.store(min_sample_period, std::memory_order_relaxed);
 		}
 
-		static const char default_char = '\0';
-		return default_char;
-	}
-
-	// String Type Conversion Operator
-	filtered_string_view::operator std::string() const {
-		std::string result;
-		result.reserve(size());
-		for (const char* p = _ptr; p != _ptr + _length; ++p) {
-			if (_predicate(*p)) {
-				result += *p;
+		// Adaptive Conjunction Call Operator
+		auto adaptive_conjunction::operator()(const char& c) const -> bool {
+			const auto& filters = _state->filters;
+			if (filters.size() > max_adaptive) {
+				return std::all_of(filters.begin(), filters.end(), [&c](const filter& f) { return f(c); });
 			}
-		}
-		return result;
-	}
-
-	// at Member Function
-	auto filtered_string_view::at(int index) -> const char& {
-		if (index < 0 || static_cast<std::size_t>(index) >= size()) {
-			throw std::domain_error("filtered_string_view::at(" + std::to_string(index) + "): invalid index");
-		}
-		int filtered_index = 0;
-		for (const char* p = _ptr; p != _ptr + _length; ++p) {
-			if (_predicate(*p)) {
-				if (filtered_index == index) {
-					return *p;
-				}
-				++filtered_index;
+			const auto left = _state->countdown.load(std::memory_order_relaxed);
+			if (left <= 1) {
+				const auto period = _state->sample_period.load(std::memory_order_relaxed);
+				_state->countdown.store(period, std::memory_order_relaxed);
+				return sample(c);
 			}
-		}
-		throw std::domain_error("filtered_string_view::at(" + std::to_string(index) + "): invalid index");
-	}
-
-	// size Member Function
-	auto filtered_string_view::size() const -> std::size_t {
-		return static_cast<std::size_t>(std::count_if(_ptr, _ptr + _length, _predicate));
-	}
-
-	// empty Member Function
-	auto filtered_string_view::empty() -> bool {
-		return size() == 0;
-	}
-
-	// data Member Function
-	const char* filtered_string_view::data() const {
-		return _ptr;
-	}
-
-	// predicate Member Function
-	auto filtered_string_view::predicate() const -> const filter& {
-		return _predicate;
-	}
-
-	// Equality Comparison Operator
-	auto operator==(const filtered_string_view& lhs, const filtered_string_view& rhs) -> bool {
-		auto lhs_filtered = static_cast<std::string>(lhs);
-		auto rhs_filtered = static_cast<std::string>(rhs);
-		return lhs_filtered == rhs_filtered;
-	}
-
-	// Not Equality Comparison Operator
-	auto operator!=(const filtered_string_view& lhs, const filtered_string_view& rhs) -> bool {
-		return !(lhs == rhs);
-	}
-
-	// Spaceship Operator
-	auto operator<=>(const filtered_string_view& lhs, const filtered_string_view& rhs) -> std::strong_ordering {
-		auto lhs_filtered = static_cast<std::string>(lhs);
-		auto rhs_filtered = static_cast<std::string>(rhs);
-		return lhs_filtered <=> rhs_filtered;
-	}
-
-	// Output Stream Operator
-	auto operator<<(std::ostream& os, const filtered_string_view& fsv) -> std::ostream& {
-		for (const char* p = fsv._ptr; p != fsv._ptr + fsv._length; ++p) {
-			if (fsv._predicate(*p)) {
-				os.put(*p);
-			}
-		}
-		return os;
-	}
-
-	// Compose function
-	auto compose(const filtered_string_view& fsv, const std::vector<filter>& filts) -> filtered_string_view {
-		auto composed_predicate = [filts](const char& c) {
-			for (const auto& f : filts) {
-				if (!f(c)) {
+			_state->countdown.store(left - 1, std::memory_order_relaxed);
+			const filter* first = filters.data();
+			auto order = _state->order.load(std::memory_order_relaxed);
+			for (auto n = filters.size(); n != 0; --n, order >>= 4U) {
+				if (!first[order & 15U](c)) {
 					return false;
 				}
 			}
 			return true;
-		};
-		return filtered_string_view(fsv.data(), composed_predicate);
-	}
-
-	// Split function
-	auto split(const filtered_string_view& fsv, const filtered_string_view& tok) -> std::vector<filtered_string_view> {
-		std::vector<filtered_string_view> result;
-		const char* fsv_start = fsv.data();
-		const char* fsv_end = fsv_start + std::strlen(fsv.data());
-		const char* tok_start = tok.data();
-		std::size_t tok_size = std::strlen(tok.data());
-
-		if (tok_size == 0 || fsv.size() == 0) {
-			result.push_back(fsv);
-			return result;
 		}
 
-		const char* segment_start = fsv_start;
-		while (segment_start < fsv_end) {
-			const char* tok_pos = std::search(segment_start, fsv_end, tok_start, tok_start + tok_size);
-
-			if (segment_start != tok_pos) {
-				result.emplace_back(segment_start, [segment_start, tok_pos, &fsv](const char& c) {
-					return &c >= segment_start && &c < tok_pos && fsv.predicate()(c);
-				});
-			}
-			else {
-				result.emplace_back("", [](const char&) { return false; });
+		// Evaluate Every Filter, Timing it and Counting Rejections
+		auto adaptive_conjunction::sample(const char& c) const -> bool {
+			using clock = std::chrono::steady_clock;
+			auto accepted = true;
+			auto start = clock::now();
+			for (std::size_t i = 0; i < _state->filters.size(); ++i) {
+				const auto passed = _state->filters[i](c);
+				const auto end = clock::now();
+				const auto spent = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+				_state->nanoseconds[i].fetch_add(static_cast<std::uint64_t>(spent), std::memory_order_relaxed);
+				start = end;
+				if (!passed) {
+					_state->rejections[i].fetch_add(1, std::memory_order_relaxed);
+					accepted = false;
+				}
 			}
-
-			if (tok_pos == fsv_end) {
-				break;
+			if ((_state->samples.fetch_add(1, std::memory_order_relaxed) + 1) % rerank_period == 0) {
+				rerank();
 			}
-
-			segment_start = tok_pos + tok_size;
+			return accepted;
 		}
 
-		if (segment_start == fsv_end) {
-			result.emplace_back("");
-		}
-
-		return result;
-	}
-
-	// Substring Function
-	auto substr(const filtered_string_view& fsv, int pos, int count) -> filtered_string_view {
-		std::size_t total_size =
-		    static_cast<std::size_t>(std::count_if(fsv.data(), fsv.data() + std::strlen(fsv.data()), fsv.predicate()));
-		if (pos < 0 || static_cast<std::size_t>(pos) >= total_size) {
-			return filtered_string_view("", [](const char&) { return false; });
-		}
-		std::size_t rcount = (count <= 0) ? (total_size - static_cast<std::size_t>(pos))
-		                                  : static_cast<std::size_t>(count);
-		const char* start = fsv.data();
-		int index = 0;
-		const char* substr_start = nullptr;
-		const char* substr_end = nullptr;
-
-		for (const char* p = start; *p != '\0'; ++p) {
-			if (fsv.predicate()(*p)) {
-				if (index == pos) {
-					substr_start = p;
-				}
-				if (index == pos + static_cast<int>(rcount)) {
-					substr_end = p;
-					break;
-				}
-				++index;
+		// Rank the Filters by Rejections per Nanosecond, Most First (Ties Keep the Given Order), and Back Off
+		// Sampling While the Order Holds. Each time includes a clock read, so filters cheaper than that rank by
+		// rejections alone.
+		void adaptive_conjunction::rerank() const {
+			const auto n = _state->filters.size();
+			auto counts = std::array<std::uint64_t, max_adaptive>{};
+			auto costs = std::array<std::uint64_t, max_adaptive>{};
+			auto ranked = std::array<std::uint64_t, max_adaptive>{};
+			for (std::size_t i = 0; i < n; ++i) {
+				counts[i] = _state->rejections[i].load(std::memory_order_relaxed);
+				_state->rejections[i].fetch_sub(counts[i] / 2, std::memory_order_relaxed);
+				costs[i] = _state->nanoseconds[i].load(std::memory_order_relaxed);
+				_state->nanoseconds[i].fetch_sub(costs[i] / 2, std::memory_order_relaxed);
+				costs[i] += 1;
+				ranked[i] = i;
 			}
+			const auto last = ranked.begin() + static_cast<std::ptrdiff_t>(n);
+			std::stable_sort(ranked.begin(), last, [&counts, &costs](auto lhs, auto rhs) {
+				return counts[lhs] * costs[rhs] > counts[rhs] * costs[lhs];
+			});
+			auto order = std::uint64_t{0};
+			for (std::size_t i = 0; i < n; ++i) {
+				order |= ranked[i] << (4 * i);
+			}
+			const auto previous = _state->order.exchange(order, std::memory_order_relaxed);
+			const auto period = _state->sample_period.load(std::memory_order_relaxed);
+			_state->sample_period.store(previous == order ? std::min(2 * period, max_sample_period) : min_sample_period,
+			                            std::memory_order_relaxed);
 		}
+	} // namespace
 
-		if (substr_start == nullptr) {
-			return filtered_string_view("", [](const char&) { return false; });
-		}
-		if (substr_end == nullptr) {
-			substr_end = start + std::strlen(fsv.data());
-		}
-
-		return filtered_string_view(substr_start, [substr_start, substr_end, &fsv](const char& c) {
-			return &c >= substr_start && &c < substr_end && fsv.predicate()(c);
-		});
-	}
-
-	// Iterator Default Constructor
-	filtered_string_view::iter::iter() noexcept
-	: _ptr(nullptr)
-	, _pred(&filtered_string_view::default_predicate) {}
-
-	// Iterator Constructor with Predicate
-	filtered_string_view::iter::iter(const char* str, const filter* pred) noexcept
-	: _ptr(str)
-	, _pred(pred) {
-		if (_ptr && !_pred->operator()(*_ptr)) {
-			advance();
-		}
-	}
-
-	// Iterator Dereference Operator
-	auto filtered_string_view::iter::operator*() const -> reference {
-		return *_ptr;
-	}
-
-	// Iterator Arrow Operator
-	auto filtered_string_view::iter::operator->() const -> pointer {
-		return _ptr;
-	}
-
-	// Iterator Pre-Increment Operator
-	auto filtered_string_view::iter::operator++() -> iter& {
-		advance();
-		return *this;
-	}
-
-	// Iterator Post-Increment Operator
-	auto filtered_string_view::iter::operator++(int) -> iter {
-		iter tmp = *this;
-		advance();
-		return tmp;
-	}
-
-	// Iterator Pre-Decrement Operator
-	auto filtered_string_view::iter::operator--() -> iter& {
-		retreat();
-		return *this;
-	}
-
-	// Iterator Post-Decrement Operator
-	auto filtered_string_view::iter::operator--(int) -> iter {
-		iter tmp = *this;
-		retreat();
-		return tmp;
-	}
-
-	// Iterator Equality Comparison Operator
-	auto filtered_string_view::iter::operator==(const iter& other) const noexcept -> bool {
-		return _ptr == other._ptr;
-	}
-
-	// Iterator Inequality Comparison Operator
-	auto filtered_string_view::iter::operator!=(const iter& other) const noexcept -> bool {
-		return !(*this == other);
-	}
-
-	// Advance Iterator to Next Valid Position
-	void filtered_string_view::iter::advance() {
-		do {
-			++_ptr;
-		} while (_ptr && !_pred->operator()(*_ptr));
-	}
-
-	// Retreat Iterator to Previous Valid Position
-	void filtered_string_view::iter::retreat() {
-		do {
-			--_ptr;
-		} while (_ptr && !_pred->operator()(*_ptr));
-	}
-
-	// Begin Iterator
-	auto filtered_string_view::begin() const -> const_iterator {
-		return const_iterator(_ptr, &_predicate);
-	}
-
-	// End Iterator
-	auto filtered_string_view::end() const -> const_iterator {
-		return const_iterator(_ptr + _length, &_predicate);
-	}
-
-	// Constant Begin Iterator
-	auto filtered_string_view::cbegin() const -> const_iterator {
-		return begin();
-	}
-
-	// Constant End Iterator
-	auto filtered_string_view::cend() const -> const_iterator {
-		return end();
-	}
-
-	// Reverse Begin Iterator
-	auto filtered_string_view::rbegin() const -> const_reverse_iterator {
-		return const_reverse_iterator(end());
-	}
-
-	// Reverse End Iterator
-	auto filtered_string_view::rend() const -> const_reverse_iterator {
-		return const_reverse_iterator(begin());
-	}
-
-	// Constant Reverse Begin Iterator
-	auto filtered_string_view::crbegin() const -> const_reverse_iterator {
-		return rbegin();
+	// Compose function
+	auto compose(const filtered_string_view& fsv, const std::vector<filter>& filts) -> filtered_string_view {
+		return filtered_string_view(fsv.raw(), adaptive_conjunction(filts));
 	}
 
-	// Constant Reverse End Iterator
-	auto filtered_string_view::crend() const -> const_reverse_iterator {
-		return rend();
-	}
 } // namespace fsv
@@ -2,20 +2,304 @@
 #define COMP6771_ASS2_FSV_H
 
 #include <compare>
+#include <concepts>
 #include <cstring>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <new>
 #include <optional>
+#include <ostream>
+#include <ranges>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "./char_set.h"
+#include "./delimiter.h"
+#include "./hash.h"
+#include "./rank_select.h"
 
 namespace fsv {
 	using filter = std::function<bool(const char&)>;
 
-	class filtered_string_view {
+	// Predicate that keeps every character; the default for views built without one
+	struct accept_all {
+		constexpr auto operator()(const char&) const noexcept -> bool {
+			return true;
+		}
+	};
+
+	// Predicate that keeps a character only if every operand keeps it. The operands are stored by value and
+	// tried in order, stopping at the first rejection, so the whole chain inlines into the scan loops.
+	template<typename... Preds>
+	class conjunction {
+	 public:
+		explicit conjunction(Preds... preds);
+
+		auto operator()(const char& c) const -> bool;
+
+	 private:
+		std::tuple<Preds...> _preds;
+	};
+
+	// Conjunction Constructor
+	template<typename... Preds>
+	conjunction<Preds...>::conjunction(Preds... preds)
+	: _preds(std::move(preds)...) {}
+
+	// Conjunction Call Operator
+	template<typename... Preds>
+	auto conjunction<Preds...>::operator()(const char& c) const -> bool {
+		return std::apply([&c](const Preds&... preds) { return (static_cast<bool>(preds(c)) && ...); }, _preds);
+	}
+
+	// Declares pred a pure function of the byte and materialises it: pred is called once for each of the
+	// 256 byte values, and a view given the resulting table scans with the vector kernels from then on,
+	// statically typed or inside a filter. pred must depend on nothing but its argument. Tables, and filters
+	// already wrapping one, are taken as they are.
+	template<typename Pred>
+	requires std::predicate<const Pred&, const char&>
+	constexpr auto pure(const Pred& pred) -> char_set {
+		if constexpr (std::same_as<Pred, char_set>) {
+			return pred;
+		}
+		else if constexpr (std::same_as<Pred, filter>) {
+			if (const auto* set = pred.template target<char_set>()) {
+				return *set;
+			}
+			return char_set(pred);
+		}
+		else {
+			return char_set(pred);
+		}
+	}
+
+	namespace detail {
+		// What compose() fuses its operands into: byte tables AND into one table, anything else is chained
+		template<typename... Preds>
+		using composed_predicate =
+		    std::conditional_t<(std::same_as<Preds, char_set> && ...), char_set, conjunction<Preds...>>;
+
+		// Predicates with no state and a trivial default constructor: the scanner calls an instance of its
+		// own, so nothing it hands out (iterators included) refers back to the view it was built from
+		template<typename Pred>
+		concept stateless_predicate = std::is_empty_v<Pred> && std::is_trivially_default_constructible_v<Pred>;
+
+		// Decides once how a predicate is scanned: char_set tables go to the SIMD kernels, accept_all needs
+		// no calls at all, anything else is called per character. A filter is inspected through target(),
+		// so a char_set keeps its kernels when it is type-erased into a filtered_string_view.
+		template<typename Pred>
+		class scanner {
+		 public:
+			scanner() noexcept;
+			explicit scanner(const Pred& pred) noexcept;
+
+			auto accepts_all() const noexcept -> bool;
+			auto count(const char* first, const char* last) const -> std::size_t;
+			auto find(const char* first, const char* last) const -> const char*;
+			auto find_not(const char* first, const char* last) const -> const char*;
+			auto find_last(const char* first, const char* last) const -> const char*;
+			auto compress(const char* first, const char* last, char* out) const -> std::size_t;
+			// The accepted position k places after the first one in [first, last), or last
+			auto nth(const char* first, const char* last, std::size_t k) const -> const char*;
+			// The k-th accepted position counting back from last (k >= 1); it must exist
+			auto nth_last(const char* first, const char* last, std::size_t k) const -> const char*;
+
+		 private:
+			static constexpr bool inspects = std::same_as<Pred, filter> || std::same_as<Pred, char_set>
+			                                 || std::same_as<Pred, accept_all>;
+
+			const Pred* _pred;
+			const char_set* _set;
+			bool _all;
+
+			auto pred() const noexcept -> const Pred&;
+		};
+
+		// Whether two predicates are known to accept exactly the same characters (false when unknown)
+		template<typename Pred>
+		auto same_predicate(const Pred& lhs, const Pred& rhs) -> bool;
+
+		// Scratch space for searching compressed blocks: on the stack unless the needle is too long to leave
+		// a reasonable block beside the bytes carried over from the previous one
+		class search_buffer {
+		 public:
+			explicit search_buffer(std::size_t needle_size);
+
+			auto data() noexcept -> char*;
+			auto size() const noexcept -> std::size_t;
+
+		 private:
+			static constexpr std::size_t local_size = 4096;
+
+			std::array<char, local_size> _local;
+			std::vector<char> _heap;
+		};
+
+		// How a view holds its predicate. Stateless predicates take no space at all. Predicates that cannot be
+		// assigned (capturing lambdas) are assigned the way std::ranges' copyable box does it: destroyed and
+		// constructed again, which is only done where the construction cannot throw halfway.
+		template<typename Pred>
+		class predicate_holder {
+			static constexpr bool copy_assignable =
+			    std::is_copy_assignable_v<Pred> || std::is_nothrow_copy_constructible_v<Pred>
+			    || (std::is_copy_constructible_v<Pred> && std::is_nothrow_move_constructible_v<Pred>);
+			static constexpr bool nothrow_copy_assign = std::is_copy_assignable_v<Pred>
+			                                                ? std::is_nothrow_copy_assignable_v<Pred>
+			                                                : std::is_nothrow_copy_constructible_v<Pred>;
+			static constexpr bool move_assignable =
+			    std::is_move_assignable_v<Pred> || std::is_nothrow_move_constructible_v<Pred>;
+			static constexpr bool nothrow_move_assign =
+			    !std::is_move_assignable_v<Pred> || std::is_nothrow_move_assignable_v<Pred>;
+
+		 public:
+			explicit predicate_holder(accept_all all)
+			requires std::constructible_from<Pred, accept_all>;
+			explicit predicate_holder(Pred pred);
+			predicate_holder(const predicate_holder& other) = default;
+			predicate_holder(predicate_holder&& other) = default;
+			~predicate_holder() = default;
+
+			auto operator=(const predicate_holder& other) noexcept(nothrow_copy_assign) -> predicate_holder&
+			requires copy_assignable;
+			auto operator=(predicate_holder&& other) noexcept(nothrow_move_assign) -> predicate_holder&
+			requires move_assignable;
+
+			auto get() const noexcept -> const Pred&;
+
+		 private:
+			[[no_unique_address]] Pred _pred;
+		};
+
+		// A filter is held as one word, so the windows split() and substr() cut from a view share its
+		// predicate instead of each copying the std::function and the state it owns. The word is 0 for
+		// accept-all, which needs no filter at all; the address of a shared, reference-counted copy; or, with
+		// the low bit set, the address of a copy that lives for the rest of the program and is not counted.
+		// Stateless callables (captureless lambdas) get one such copy per type and function pointers one per
+		// function, so views over them never allocate; other filters allocate their copy once per view.
+		template<>
+		class predicate_holder<filter> {
+		 public:
+			predicate_holder() noexcept = default;
+			explicit predicate_holder(accept_all) noexcept;
+			explicit predicate_holder(filter pred);
+			// Any callable a filter can hold. A filtered_string_view constructor's predicate converts through
+			// here, while the callable's own type is still known.
+			template<typename F>
+			requires(!std::same_as<std::remove_cvref_t<F>, predicate_holder>) && std::constructible_from<filter, F>
+			predicate_holder(F&& pred);
+			predicate_holder(const predicate_holder& other) noexcept;
+			predicate_holder(predicate_holder&& other) noexcept;
+			~predicate_holder();
+
+			auto operator=(const predicate_holder& other) noexcept -> predicate_holder&;
+			auto operator=(predicate_holder&& other) noexcept -> predicate_holder&;
+
+			auto get() const noexcept -> const filter&;
+
+		 private:
+			struct node {
+				filter pred;
+				std::atomic<std::size_t> refs;
+			};
+
+			static constexpr std::uintptr_t permanent = 1;
+
+			std::uintptr_t _word = 0;
+
+			template<typename F>
+			static auto make(F&& pred) -> std::uintptr_t;
+			static auto allocate(filter pred) -> std::uintptr_t;
+			template<typename F>
+			static auto interned() -> std::uintptr_t;
+			template<typename F>
+			static auto interned(F function) -> std::uintptr_t;
+			static auto counted(std::uintptr_t word) noexcept -> node*;
+			void release() noexcept;
+		};
+
+		// What the view constructors take as their predicate: Pred itself, except that filtered_string_view
+		// takes the holder, so that the caller's callable converts into it before std::function erases it
+		template<typename Pred>
+		using predicate_param = std::conditional_t<std::same_as<Pred, filter>, predicate_holder<filter>, Pred>;
+
+		// The accept-all filter every predicate_holder<filter> without a node stands for
+		auto accept_all_filter() noexcept -> const filter&;
+
+		// A view's filtered size and rank/select index, both worked out on first use, folded into one word:
+		// 0 while unknown, size << 1 | 1 once counted, or the address of a reference-counted index (which
+		// knows the size) once built. Copies share the index. The word is a relaxed atomic so concurrent const
+		// size() calls on one view stay race-free.
+		class view_cache {
+		 public:
+			static constexpr std::size_t unknown_size = std::numeric_limits<std::size_t>::max();
+
+			view_cache() noexcept = default;
+			view_cache(const view_cache& other) noexcept;
+			view_cache(view_cache&& other) noexcept;
+			~view_cache();
+
+			auto operator=(const view_cache& other) noexcept -> view_cache&;
+			auto operator=(view_cache&& other) noexcept -> view_cache&;
+
+			// The filtered size, or unknown_size
+			auto size() const noexcept -> std::size_t;
+			// The index, or nullptr when none has been built
+			auto index() const noexcept -> const rank_select*;
+			// Records a counted size; a size or index already known is kept
+			void remember(std::size_t size) const noexcept;
+			// Installs a freshly built index in place of whatever was known
+			auto build(rank_select index) -> const rank_select&;
+
+		 private:
+			struct shared_index {
+				rank_select index;
+				std::atomic<std::size_t> refs;
+			};
+
+			mutable std::atomic<std::uintptr_t> _word{0};
+
+			static auto node(std::uintptr_t word) noexcept -> shared_index*;
+			static void acquire(std::uintptr_t word) noexcept;
+			static void release(std::uintptr_t word) noexcept;
+		};
+
+		// Lexicographic comparison of two ranges of string_view runs, memcmp-ing the overlap of the current
+		// runs and stopping at the first difference
+		template<typename LhsRuns, typename RhsRuns>
+		auto compare_runs(const LhsRuns& lhs, const RhsRuns& rhs) -> std::strong_ordering;
+	} // namespace detail
+
+	// substr reads the private rank/select index, so it is declared ahead of the class that befriends it
+	template<typename Pred>
+	class basic_filtered_string_view;
+	template<typename Pred>
+	auto substr(const basic_filtered_string_view<Pred>& fsv, int pos = 0, int count = 0)
+	    -> basic_filtered_string_view<Pred>;
+
+	// A view over [_ptr, _ptr + _length) exposing only the characters accepted by a Pred.
+	// Pred is stored by value and called directly, so a lambda or function object inlines into
+	// every scan loop; filtered_string_view is the type-erased form over fsv::filter.
+	template<typename Pred = filter>
+	class basic_filtered_string_view {
 		class iter {
 		 public:
+			using iterator_concept = std::bidirectional_iterator_tag;
 			using iterator_category = std::bidirectional_iterator_tag;
 			using value_type = char;
 			using difference_type = std::ptrdiff_t;
@@ -23,7 +307,7 @@ namespace fsv {
 			using reference = const char&;
 
 			iter() noexcept;
-			iter(const char* str, const filter* pred) noexcept;
+			iter(const char* first, const char* last, const char* pos, detail::scanner<Pred> scan) noexcept;
 
 			auto operator*() const -> reference;
 			auto operator->() const -> pointer;
@@ -35,39 +319,113 @@ namespace fsv {
 
 			auto operator==(const iter& other) const noexcept -> bool;
 			auto operator!=(const iter& other) const noexcept -> bool;
+			auto operator==(std::default_sentinel_t) const noexcept -> bool;
 
 		 private:
+			const char* _first;
+			const char* _last;
 			const char* _ptr;
-			const filter* _pred;
+			detail::scanner<Pred> _scan;
 
 			void advance();
 			void retreat();
 		};
 		using const_iterator = iter;
 		using const_reverse_iterator = std::reverse_iterator<iter>;
+		using holder = detail::predicate_holder<Pred>;
+
+		template<typename>
+		friend class basic_filtered_string_view;
+		template<typename P>
+		friend auto substr(const basic_filtered_string_view<P>& fsv, int pos, int count)
+		    -> basic_filtered_string_view<P>;
 
 	 public:
-		static filter default_predicate;
+		using predicate_type = Pred;
+
+		static constexpr std::size_t npos = std::string_view::npos;
+
+		// Where a match starts: its filtered index and the raw offset of its first character from data()
+		struct match {
+			std::size_t index;
+			std::size_t offset;
+		};
+
+		// Maximal runs of accepted characters as string_views into the buffer; valid as long as the view
+		class run_range {
+		 public:
+			class iterator {
+			 public:
+				using iterator_concept = std::forward_iterator_tag;
+				using iterator_category = std::input_iterator_tag;
+				using value_type = std::string_view;
+				using difference_type = std::ptrdiff_t;
+
+				iterator() noexcept;
+				iterator(const char* run, const char* last, detail::scanner<Pred> scan) noexcept;
+
+				auto operator*() const -> value_type;
+				auto operator++() -> iterator&;
+				auto operator++(int) -> iterator;
+				auto operator==(const iterator& other) const noexcept -> bool;
+
+			 private:
+				const char* _run;
+				const char* _run_end;
+				const char* _last;
+				detail::scanner<Pred> _scan;
+			};
+
+			run_range(const char* first, const char* last, detail::scanner<Pred> scan) noexcept;
+
+			auto begin() const -> iterator;
+			auto end() const -> iterator;
+
+		 private:
+			const char* _first;
+			const char* _last;
+			detail::scanner<Pred> _scan;
+		};
 
 		const char* data() const;
 
 		// Constructors
-		filtered_string_view() noexcept;
-		filtered_string_view(const std::string& str);
-		filtered_string_view(const std::string& str, filter predicate);
-		filtered_string_view(const char* str);
-		filtered_string_view(const char* str, filter predicate);
+		basic_filtered_string_view() noexcept
+		requires std::constructible_from<Pred, accept_all>;
+		basic_filtered_string_view(const std::string& str)
+		requires std::constructible_from<Pred, accept_all>;
+		basic_filtered_string_view(const std::string& str, detail::predicate_param<Pred> predicate);
+		basic_filtered_string_view(const char* str)
+		requires std::constructible_from<Pred, accept_all>;
+		basic_filtered_string_view(const char* str, detail::predicate_param<Pred> predicate);
+		basic_filtered_string_view(const char* str, std::size_t length)
+		requires std::constructible_from<Pred, accept_all>;
+		basic_filtered_string_view(const char* str, std::size_t length, detail::predicate_param<Pred> predicate);
+		basic_filtered_string_view(std::string_view str)
+		requires std::constructible_from<Pred, accept_all>;
+		basic_filtered_string_view(std::string_view str, detail::predicate_param<Pred> predicate);
+
+		// Converting Constructor (e.g. a statically typed view to filtered_string_view)
+		template<typename Other>
+		requires(!std::same_as<Other, Pred>) && std::constructible_from<Pred, const Other&>
+		basic_filtered_string_view(const basic_filtered_string_view<Other>& other);
 
 		// Copy and Move Constructors
-		filtered_string_view(const filtered_string_view& other) noexcept;
-		filtered_string_view(filtered_string_view&& other) noexcept;
+		basic_filtered_string_view(const basic_filtered_string_view& other) noexcept(
+		    std::is_nothrow_copy_constructible_v<holder>);
+		basic_filtered_string_view(basic_filtered_string_view&& other) noexcept(
+		    std::is_nothrow_move_constructible_v<holder>);
 
 		// Destructor
-		~filtered_string_view() = default;
+		~basic_filtered_string_view() = default;
 
 		// Member Operators
-		auto operator=(const filtered_string_view& other) noexcept -> filtered_string_view&;
-		auto operator=(filtered_string_view&& other) noexcept -> filtered_string_view&;
+		auto operator=(const basic_filtered_string_view& other) noexcept(std::is_nothrow_copy_assignable_v<holder>)
+		    -> basic_filtered_string_view&
+		requires std::is_copy_assignable_v<holder>;
+		auto operator=(basic_filtered_string_view&& other) noexcept(std::is_nothrow_move_assignable_v<holder>)
+		    -> basic_filtered_string_view&
+		requires std::is_move_assignable_v<holder>;
 		auto operator[](int n) -> const char&;
 		explicit operator std::string() const;
 
@@ -75,12 +433,62 @@ namespace fsv {
 		auto at(int index) -> const char&;
 		auto empty() -> bool;
 		auto size() const -> std::size_t;
-		auto predicate() const -> const filter&;
+		auto predicate() const -> const Pred&;
+		auto raw() const noexcept -> std::string_view;
+		auto window(std::size_t offset, std::size_t count) const -> basic_filtered_string_view;
+		auto find(std::string_view needle, std::size_t pos = 0) const -> std::size_t;
+		auto rfind(std::string_view needle, std::size_t pos = npos) const -> std::size_t;
+		auto find_match(std::string_view needle, std::size_t pos = 0) const -> std::optional<match>;
+		auto rfind_match(std::string_view needle, std::size_t pos = npos) const -> std::optional<match>;
+		auto contains(std::string_view needle) const -> bool;
+		auto starts_with(std::string_view prefix) const -> bool;
+		auto ends_with(std::string_view suffix) const -> bool;
+		auto runs() const -> run_range;
+		template<typename Callback>
+		requires std::invocable<Callback&, std::string_view>
+		void for_each_run(Callback callback) const;
 
 		// Non-Member Operators
-		friend auto operator==(const filtered_string_view& lhs, const filtered_string_view& rhs) -> bool;
-		friend auto operator<=>(const filtered_string_view& lhs, const filtered_string_view& rhs) -> std::strong_ordering;
-		friend auto operator<<(std::ostream& os, const filtered_string_view& fsv) -> std::ostream&;
+		friend auto operator==(const basic_filtered_string_view& lhs, const basic_filtered_string_view& rhs) -> bool {
+			if (lhs.same_window(rhs)) {
+				return true;
+			}
+			const auto lhs_size = lhs._cache.size();
+			const auto rhs_size = rhs._cache.size();
+			const auto unknown_size = detail::view_cache::unknown_size;
+			if (lhs_size != unknown_size && rhs_size != unknown_size && lhs_size != rhs_size) {
+				return false;
+			}
+			return std::is_eq(detail::compare_runs(lhs.runs(), rhs.runs()));
+		}
+
+		friend auto operator<=>(const basic_filtered_string_view& lhs, const basic_filtered_string_view& rhs)
+		    -> std::strong_ordering {
+			if (lhs.same_window(rhs)) {
+				return std::strong_ordering::equal;
+			}
+			return detail::compare_runs(lhs.runs(), rhs.runs());
+		}
+
+		// Hands each accepted run to the stream buffer in one sputn under a single sentry; an accept-all view
+		// is one run, so the whole buffer goes out in one call.
+		friend auto operator<<(std::ostream& os, const basic_filtered_string_view& fsv) -> std::ostream& {
+			const std::ostream::sentry sentry(os);
+			if (!sentry) {
+				return os;
+			}
+			auto* buf = os.rdbuf();
+			auto written = true;
+			fsv.for_each_run([buf, &written](std::string_view run) {
+				const auto n = static_cast<std::streamsize>(run.size());
+				written = buf->sputn(run.data(), n) == n;
+				return written;
+			});
+			if (!written) {
+				os.setstate(std::ios_base::badbit);
+			}
+			return os;
+		}
 
 		// Range
 		auto begin() const -> const_iterator;
@@ -95,14 +503,1618 @@ namespace fsv {
 	 private:
 		const char* _ptr;
 		std::size_t _length;
-		filter _predicate;
+		// Filtered length, counted once (the buffer and predicate never change under a view), or the
+		// rank/select index over the accepted positions once the first random access has built it
+		detail::view_cache _cache;
+		[[no_unique_address]] detail::predicate_holder<Pred> _predicate;
+
+		// Shares the holder of the view a window is cut from; filtered_string_view's public constructor
+		// already takes a holder
+		basic_filtered_string_view(const char* str,
+		                           std::size_t length,
+		                           const detail::predicate_holder<Pred>& predicate)
+		requires(!std::same_as<Pred, filter>);
+
+		auto ensure_index() -> std::size_t;
+		auto locate(std::size_t n) const -> const char*;
+		auto same_window(const basic_filtered_string_view& other) const -> bool;
+		auto search_forward(std::string_view needle, const char* start, std::size_t index) const
+		    -> std::optional<match>;
+		auto search_backward(std::string_view needle, const char* end, std::size_t end_index) const
+		    -> std::optional<match>;
+	};
+
+	using filtered_string_view = basic_filtered_string_view<filter>;
+
+	// Deduction Guides
+	template<typename Pred>
+	requires std::predicate<const Pred&, const char&>
+	basic_filtered_string_view(const std::string&, Pred) -> basic_filtered_string_view<Pred>;
+	template<typename Pred>
+	requires std::predicate<const Pred&, const char&>
+	basic_filtered_string_view(const char*, Pred) -> basic_filtered_string_view<Pred>;
+	template<typename Pred>
+	requires std::predicate<const Pred&, const char&>
+	basic_filtered_string_view(const char*, std::size_t, Pred) -> basic_filtered_string_view<Pred>;
+	template<typename Pred>
+	requires std::predicate<const Pred&, const char&>
+	basic_filtered_string_view(std::string_view, Pred) -> basic_filtered_string_view<Pred>;
+
+	// The segments of a view between occurrences of a raw delimiter, found one per increment.
+	// Segments are windows of the source view with its predicate, exactly as split() returns them, so
+	// stopping after the first few fields never searches the rest of the buffer.
+	template<typename Pred>
+	class split_view : public std::ranges::view_interface<split_view<Pred>> {
+	 public:
+		class iterator {
+		 public:
+			using iterator_concept = std::forward_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+			using value_type = basic_filtered_string_view<Pred>;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() noexcept;
+			iterator(const split_view* parent,
+			         const char* segment,
+			         const char* segment_end,
+			         detail::delimiter_finder finder) noexcept;
+
+			auto operator*() const -> value_type;
+			auto operator++() -> iterator&;
+			auto operator++(int) -> iterator;
+			auto operator==(const iterator& other) const noexcept -> bool;
+
+		 private:
+			const split_view* _parent;
+			const char* _segment;
+			const char* _segment_end;
+			detail::delimiter_finder _finder;
+			bool _done;
+		};
+
+		split_view() = default;
+		split_view(basic_filtered_string_view<Pred> fsv, std::string_view tok);
+
+		auto begin() const -> iterator;
+		auto end() const -> iterator;
+
+	 private:
+		basic_filtered_string_view<Pred> _fsv;
+		std::string_view _tok;
+	};
+
+	// How split_if treats adjacent delimiters: keep_empty yields an empty segment between each pair (and
+	// at either end), collapse treats a run as one separator and never yields an empty segment.
+	enum class split_mode { keep_empty, collapse };
+
+	// The segments of a view between raw bytes matching a delimiter predicate. The delimiter is scanned
+	// like a view predicate, so a char_set (directly or inside a filter) uses the vector find kernels.
+	template<typename Pred, typename Delim>
+	class split_if_view : public std::ranges::view_interface<split_if_view<Pred, Delim>> {
+	 public:
+		class iterator {
+		 public:
+			using iterator_concept = std::forward_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+			using value_type = basic_filtered_string_view<Pred>;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() noexcept;
+			iterator(const split_if_view* parent, const char* segment) noexcept;
+
+			auto operator*() const -> value_type;
+			auto operator++() -> iterator&;
+			auto operator++(int) -> iterator;
+			auto operator==(const iterator& other) const noexcept -> bool;
+
+		 private:
+			const split_if_view* _parent;
+			const char* _segment;
+			const char* _segment_end;
+			detail::scanner<Delim> _scan;
+		};
+
+		split_if_view() = default;
+		split_if_view(basic_filtered_string_view<Pred> fsv, Delim delim, split_mode mode);
+
+		auto begin() const -> iterator;
+		auto end() const -> iterator;
+
+	 private:
+		basic_filtered_string_view<Pred> _fsv;
+		Delim _delim;
+		split_mode _mode;
 	};
 
 	// Non-Member Utility Functions
+	// split and substr return windows of the original view: they keep its predicate and only narrow
+	// [_ptr, _ptr + _length), so slicing a slice costs the same as slicing the original.
+	// The vector form of compose samples which filters reject most often and tries those first, so the
+	// order the filters are listed in does not matter; filters should therefore be free of side effects.
 	auto compose(const filtered_string_view& fsv, const std::vector<filter>& filts) -> filtered_string_view;
-	auto split(const filtered_string_view& fsv, const filtered_string_view& tok) -> std::vector<filtered_string_view>;
-	auto substr(const filtered_string_view& fsv, int pos = 0, int count = 0) -> filtered_string_view;
+	template<typename Pred, typename... Preds>
+	requires(sizeof...(Preds) > 0) && (std::predicate<const Preds&, const char&> && ...)
+	auto compose(const basic_filtered_string_view<Pred>& fsv, Preds... preds)
+	    -> basic_filtered_string_view<detail::composed_predicate<Preds...>>;
+	template<typename Pred>
+	auto split(const basic_filtered_string_view<Pred>& fsv, const filtered_string_view& tok)
+	    -> std::vector<basic_filtered_string_view<Pred>>;
+	template<typename Pred>
+	auto split_range(const basic_filtered_string_view<Pred>& fsv, std::string_view tok) -> split_view<Pred>;
+	template<typename Pred>
+	auto split_parallel(const basic_filtered_string_view<Pred>& fsv,
+	                    const filtered_string_view& tok,
+	                    std::size_t threads = 0) -> std::vector<basic_filtered_string_view<Pred>>;
+	template<typename Pred, typename Delim>
+	requires std::predicate<const Delim&, const char&>
+	auto split_if(const basic_filtered_string_view<Pred>& fsv, Delim delim, split_mode mode = split_mode::keep_empty)
+	    -> split_if_view<Pred, Delim>;
+
+	// Scanner Default Constructor
+	template<typename Pred>
+	detail::scanner<Pred>::scanner() noexcept
+	: _pred(nullptr)
+	, _set(nullptr)
+	, _all(false) {}
+
+	// Scanner Constructor
+	template<typename Pred>
+	detail::scanner<Pred>::scanner(const Pred& pred) noexcept
+	: _pred(&pred)
+	, _set(nullptr)
+	, _all(false) {
+		if constexpr (std::same_as<Pred, char_set>) {
+			_set = &pred;
+		}
+		else if constexpr (std::same_as<Pred, accept_all>) {
+			_all = true;
+		}
+		else if constexpr (std::same_as<Pred, filter>) {
+			_set = pred.template target<char_set>();
+			_all = pred.template target<accept_all>() != nullptr;
+		}
+	}
+
+	// Scanner accepts_all Member Function
+	template<typename Pred>
+	auto detail::scanner<Pred>::accepts_all() const noexcept -> bool {
+		return _all;
+	}
+
+	// Scanner count Member Function
+	template<typename Pred>
+	auto detail::scanner<Pred>::count(const char* first, const char* last) const -> std::size_t {
+		if constexpr (inspects) {
+			if (_all) {
+				return static_cast<std::size_t>(last - first);
+			}
+			if (_set) {
+				return detail::count(first, last, *_set);
+			}
+		}
+		return static_cast<std::size_t>(std::count_if(first, last, std::cref(pred())));
+	}
+
+	// Scanner find Member Function
+	template<typename Pred>
+	auto detail::scanner<Pred>::find(const char* first, const char* last) const -> const char* {
+		if constexpr (inspects) {
+			if (_all) {
+				return first;
+			}
+			if (_set) {
+				return detail::find(first, last, *_set);
+			}
+		}
+		return std::find_if(first, last, std::cref(pred()));
+	}
+
+	// Scanner find_not Member Function
+	template<typename Pred>
+	auto detail::scanner<Pred>::find_not(const char* first, const char* last) const -> const char* {
+		if constexpr (inspects) {
+			if (_all) {
+				return last;
+			}
+			if (_set) {
+				return detail::find_not(first, last, *_set);
+			}
+		}
+		return std::find_if_not(first, last, std::cref(pred()));
+	}
+
+	// Scanner find_last Member Function
+	template<typename Pred>
+	auto detail::scanner<Pred>::find_last(const char* first, const char* last) const -> const char* {
+		if constexpr (inspects) {
+			if (_all) {
+				return first == last ? last : last - 1;
+			}
+			if (_set) {
+				return detail::find_last(first, last, *_set);
+			}
+		}
+		for (const char* p = last; p != first;) {
+			--p;
+			if (pred()(*p)) {
+				return p;
+			}
+		}
+		return last;
+	}
+
+	// Scanner compress Member Function: copies the accepted characters to out, which has room for all of
+	// [first, last), and returns how many were kept. Generic predicates store unconditionally and advance
+	// by the predicate's result, so the loop has no data-dependent branch.
+	template<typename Pred>
+	auto detail::scanner<Pred>::compress(const char* first, const char* last, char* out) const -> std::size_t {
+		if constexpr (inspects) {
+			if (_all) {
+				std::copy(first, last, out);
+				return static_cast<std::size_t>(last - first);
+			}
+			if (_set) {
+				return detail::compress(first, last, *_set, out);
+			}
+		}
+		std::size_t n = 0;
+		for (; first != last; ++first) {
+			out[n] = *first;
+			n += pred()(*first) ? 1U : 0U;
+		}
+		return n;
+	}
+
+	// Scanner nth Member Function
+	template<typename Pred>
+	auto detail::scanner<Pred>::nth(const char* first, const char* last, std::size_t k) const -> const char* {
+		if (_all) {
+			return first + std::min(k, static_cast<std::size_t>(last - first));
+		}
+		const char* p = find(first, last);
+		for (; k > 0 && p != last; --k) {
+			p = find(p + 1, last);
+		}
+		return p;
+	}
+
+	// Scanner nth_last Member Function
+	template<typename Pred>
+	auto detail::scanner<Pred>::nth_last(const char* first, const char* last, std::size_t k) const -> const char* {
+		if (_all) {
+			return last - k;
+		}
+		for (; k > 0; --k) {
+			last = find_last(first, last);
+		}
+		return last;
+	}
+
+	// The Predicate to Call: a stateless one through a constant-initialized instance, not the view's copy
+	template<typename Pred>
+	auto detail::scanner<Pred>::pred() const noexcept -> const Pred& {
+		if constexpr (stateless_predicate<Pred>) {
+			static const auto instance = Pred{};
+			return instance;
+		}
+		else {
+			return *_pred;
+		}
+	}
+
+	// Predicate Identity
+	// Stateless predicates of one type always agree; tables compare by content; a filter is identified
+	// through the char_set or accept_all it wraps. Other closures cannot be compared and report false.
+	template<typename Pred>
+	auto detail::same_predicate(const Pred& lhs, const Pred& rhs) -> bool {
+		if (&lhs == &rhs) {
+			return true;
+		}
+		if constexpr (std::same_as<Pred, filter>) {
+			if (lhs.target_type() != rhs.target_type()) {
+				return false;
+			}
+			if (const auto* set = lhs.template target<char_set>()) {
+				return *set == *rhs.template target<char_set>();
+			}
+			return lhs.template target<accept_all>() != nullptr;
+		}
+		else if constexpr (std::is_empty_v<Pred>) {
+			return true;
+		}
+		else if constexpr (std::equality_comparable<Pred>) {
+			return lhs == rhs;
+		}
+		else {
+			return false;
+		}
+	}
+
+	// Predicate Holder Accept-All Constructor
+	template<typename Pred>
+	detail::predicate_holder<Pred>::predicate_holder(accept_all all)
+	requires std::constructible_from<Pred, accept_all>
+	: _pred(all) {}
+
+	// Predicate Holder Constructor
+	template<typename Pred>
+	detail::predicate_holder<Pred>::predicate_holder(Pred pred)
+	: _pred(std::move(pred)) {}
+
+	// Predicate Holder Copy Assignment Operator: assigns when Pred can, otherwise rebuilds it in place from a
+	// copy (made first, so a throwing copy leaves this holder untouched)
+	template<typename Pred>
+	auto detail::predicate_holder<Pred>::operator=(const predicate_holder& other) noexcept(nothrow_copy_assign)
+	    -> predicate_holder&
+	requires copy_assignable
+	{
+		if constexpr (std::is_copy_assignable_v<Pred>) {
+			*std::launder(&_pred) = other.get();
+		}
+		else if (this != &other) {
+			if constexpr (std::is_nothrow_copy_constructible_v<Pred>) {
+				std::destroy_at(std::launder(&_pred));
+				std::construct_at(&_pred, other.get());
+			}
+			else {
+				auto copy = Pred(other.get());
+				std::destroy_at(std::launder(&_pred));
+				std::construct_at(&_pred, std::move(copy));
+			}
+		}
+		return *this;
+	}
+
+	// Predicate Holder Move Assignment Operator
+	template<typename Pred>
+	auto detail::predicate_holder<Pred>::operator=(predicate_holder&& other) noexcept(nothrow_move_assign)
+	    -> predicate_holder&
+	requires move_assignable
+	{
+		auto& source = const_cast<Pred&>(other.get());
+		if constexpr (std::is_move_assignable_v<Pred>) {
+			*std::launder(&_pred) = std::move(source);
+		}
+		else if (this != &other) {
+			std::destroy_at(std::launder(&_pred));
+			std::construct_at(&_pred, std::move(source));
+		}
+		return *this;
+	}
+
+	// Predicate Holder get Member Function: a predicate rebuilt in place is reached through launder
+	template<typename Pred>
+	auto detail::predicate_holder<Pred>::get() const noexcept -> const Pred& {
+		if constexpr (std::is_copy_assignable_v<Pred> && std::is_move_assignable_v<Pred>) {
+			return _pred;
+		}
+		else {
+			return *std::launder(&_pred);
+		}
+	}
+
+	// Filter Holder Accept-All Constructor: the null holder, with nothing to allocate
+	inline detail::predicate_holder<filter>::predicate_holder(accept_all) noexcept {}
+
+	// Filter Holder Callable Constructor
+	template<typename F>
+	requires(!std::same_as<std::remove_cvref_t<F>, detail::predicate_holder<filter>>)
+	        && std::constructible_from<filter, F>
+	detail::predicate_holder<filter>::predicate_holder(F&& pred)
+	: _word(make(std::forward<F>(pred))) {}
+
+	// Filter Holder Copy Constructor
+	inline detail::predicate_holder<filter>::predicate_holder(const predicate_holder& other) noexcept
+	: _word(other._word) {
+		if (auto* shared = counted(_word)) {
+			shared->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// Filter Holder Move Constructor
+	inline detail::predicate_holder<filter>::predicate_holder(predicate_holder&& other) noexcept
+	: _word(std::exchange(other._word, 0)) {}
+
+	// Filter Holder Destructor
+	inline detail::predicate_holder<filter>::~predicate_holder() {
+		release();
+	}
+
+	// Filter Holder Copy Assignment Operator
+	inline auto detail::predicate_holder<filter>::operator=(const predicate_holder& other) noexcept
+	    -> predicate_holder& {
+		if (auto* shared = counted(other._word)) {
+			shared->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+		release();
+		_word = other._word;
+		return *this;
+	}
+
+	// Filter Holder Move Assignment Operator
+	inline auto detail::predicate_holder<filter>::operator=(predicate_holder&& other) noexcept -> predicate_holder& {
+		if (this != &other) {
+			release();
+			_word = std::exchange(other._word, 0);
+		}
+		return *this;
+	}
+
+	// Filter Holder get Member Function
+	inline auto detail::predicate_holder<filter>::get() const noexcept -> const filter& {
+		if (_word == 0) {
+			return accept_all_filter();
+		}
+		return reinterpret_cast<const node*>(_word & ~permanent)->pred;
+	}
+
+	// Word for a Callable: accept-all is 0, stateless callables and function pointers share a permanent
+	// copy, and anything else gets a counted copy of its own
+	template<typename F>
+	auto detail::predicate_holder<filter>::make(F&& pred) -> std::uintptr_t {
+		using callable = std::remove_cvref_t<F>;
+		if constexpr (std::same_as<callable, accept_all>) {
+			return 0;
+		}
+		else if constexpr (stateless_predicate<callable> && std::is_trivially_copyable_v<callable>) {
+			return interned<callable>();
+		}
+		else if constexpr (std::is_pointer_v<callable> && std::is_function_v<std::remove_pointer_t<callable>>) {
+			return pred != nullptr ? interned(pred) : allocate(filter(pred));
+		}
+		else {
+			return allocate(filter(std::forward<F>(pred)));
+		}
+	}
+
+	// Permanent Copy of a Stateless Callable: one per type, built in static storage on first use and never
+	// destroyed, so views holding it stay valid while other statics are torn down
+	template<typename F>
+	auto detail::predicate_holder<filter>::interned() -> std::uintptr_t {
+		alignas(node) static std::array<std::byte, sizeof(node)> storage;
+		static const auto word =
+		    reinterpret_cast<std::uintptr_t>(::new (static_cast<void*>(storage.data())) node{filter(F{}), 0});
+		return word | permanent;
+	}
+
+	// Permanent Copy of a Function Pointer: one per function, found under a shared lock. The table and its
+	// copies are never freed, for the same reason.
+	template<typename F>
+	auto detail::predicate_holder<filter>::interned(F function) -> std::uintptr_t {
+		static auto& mutex = *new std::shared_mutex();
+		static auto& words = *new std::unordered_map<F, std::uintptr_t>();
+		{
+			const auto lock = std::shared_lock(mutex);
+			if (const auto found = words.find(function); found != words.end()) {
+				return found->second;
+			}
+		}
+		const auto lock = std::unique_lock(mutex);
+		auto& word = words[function];
+		if (word == 0) {
+			word = reinterpret_cast<std::uintptr_t>(new node{filter(function), 0}) | permanent;
+		}
+		return word;
+	}
+
+	// The Node a Word Counts References On, or nullptr for accept-all and permanent copies
+	inline auto detail::predicate_holder<filter>::counted(std::uintptr_t word) noexcept -> node* {
+		return word != 0 && (word & permanent) == 0 ? reinterpret_cast<node*>(word) : nullptr;
+	}
+
+	// Drop this Holder's Reference, Freeing the Shared Filter with the Last One
+	inline void detail::predicate_holder<filter>::release() noexcept {
+		auto* shared = counted(_word);
+		if (shared != nullptr && shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete shared;
+		}
+	}
+
+	// View Cache Copy Constructor
+	inline detail::view_cache::view_cache(const view_cache& other) noexcept
+	: _word(other._word.load(std::memory_order_relaxed)) {
+		acquire(_word.load(std::memory_order_relaxed));
+	}
+
+	// View Cache Move Constructor
+	inline detail::view_cache::view_cache(view_cache&& other) noexcept
+	: _word(other._word.exchange(0, std::memory_order_relaxed)) {}
+
+	// View Cache Destructor
+	inline detail::view_cache::~view_cache() {
+		release(_word.load(std::memory_order_relaxed));
+	}
+
+	// View Cache Copy Assignment Operator
+	inline auto detail::view_cache::operator=(const view_cache& other) noexcept -> view_cache& {
+		const auto word = other._word.load(std::memory_order_relaxed);
+		acquire(word);
+		release(_word.exchange(word, std::memory_order_relaxed));
+		return *this;
+	}
+
+	// View Cache Move Assignment Operator
+	inline auto detail::view_cache::operator=(view_cache&& other) noexcept -> view_cache& {
+		if (this != &other) {
+			release(_word.exchange(other._word.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed));
+		}
+		return *this;
+	}
+
+	// View Cache size Member Function
+	inline auto detail::view_cache::size() const noexcept -> std::size_t {
+		const auto word = _word.load(std::memory_order_relaxed);
+		if (word == 0) {
+			return unknown_size;
+		}
+		if ((word & 1U) != 0) {
+			return static_cast<std::size_t>(word >> 1U);
+		}
+		return node(word)->index.size();
+	}
+
+	// View Cache index Member Function
+	inline auto detail::view_cache::index() const noexcept -> const rank_select* {
+		auto* shared = node(_word.load(std::memory_order_relaxed));
+		return shared != nullptr ? &shared->index : nullptr;
+	}
+
+	// View Cache remember Member Function
+	inline void detail::view_cache::remember(std::size_t size) const noexcept {
+		auto expected = std::uintptr_t{0};
+		_word.compare_exchange_strong(expected,
+		                              (static_cast<std::uintptr_t>(size) << 1U) | 1U,
+		                              std::memory_order_relaxed);
+	}
+
+	// The Shared Index a Word Points to, if Any
+	inline auto detail::view_cache::node(std::uintptr_t word) noexcept -> shared_index* {
+		return word != 0 && (word & 1U) == 0 ? reinterpret_cast<shared_index*>(word) : nullptr;
+	}
+
+	// Take a Reference to the Index a Word Points to, if Any
+	inline void detail::view_cache::acquire(std::uintptr_t word) noexcept {
+		if (auto* shared = node(word)) {
+			shared->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// Drop a Reference to the Index a Word Points to, Freeing it with the Last One
+	inline void detail::view_cache::release(std::uintptr_t word) noexcept {
+		auto* shared = node(word);
+		if (shared != nullptr && shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete shared;
+		}
+	}
+
+	// Run-Wise Comparison
+	template<typename LhsRuns, typename RhsRuns>
+	auto detail::compare_runs(const LhsRuns& lhs, const RhsRuns& rhs) -> std::strong_ordering {
+		auto lhs_it = lhs.begin();
+		auto rhs_it = rhs.begin();
+		auto lhs_run = std::string_view();
+		auto rhs_run = std::string_view();
+		while (true) {
+			for (; lhs_run.empty() && lhs_it != lhs.end(); ++lhs_it) {
+				lhs_run = *lhs_it;
+			}
+			for (; rhs_run.empty() && rhs_it != rhs.end(); ++rhs_it) {
+				rhs_run = *rhs_it;
+			}
+			if (lhs_run.empty() || rhs_run.empty()) {
+				return !lhs_run.empty() <=> !rhs_run.empty();
+			}
+			const auto n = std::min(lhs_run.size(), rhs_run.size());
+			if (const int diff = std::char_traits<char>::compare(lhs_run.data(), rhs_run.data(), n); diff != 0) {
+				return diff <=> 0;
+			}
+			lhs_run.remove_prefix(n);
+			rhs_run.remove_prefix(n);
+		}
+	}
+
+	// Default Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view() noexcept
+	requires std::constructible_from<Pred, accept_all>
+	: _ptr(nullptr)
+	, _length(0)
+	, _cache()
+	, _predicate(accept_all{}) {}
+
+	// Implicit String Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(const std::string& str)
+	requires std::constructible_from<Pred, accept_all>
+	: _ptr(str.data())
+	, _length(str.size())
+	, _cache()
+	, _predicate(accept_all{}) {}
+
+	// String Constructor with Predicate
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(const std::string& str,
+	                                                             detail::predicate_param<Pred> predicate)
+	: _ptr(str.data())
+	, _length(str.size())
+	, _cache()
+	, _predicate(std::move(predicate)) {}
+
+	// Implicit Null-Terminated String Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(const char* str)
+	requires std::constructible_from<Pred, accept_all>
+	: _ptr(str)
+	, _length(std::strlen(str))
+	, _cache()
+	, _predicate(accept_all{}) {}
+
+	// Null-Terminated String with Predicate Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(const char* str,
+	                                                             detail::predicate_param<Pred> predicate)
+	: _ptr(str)
+	, _length(std::strlen(str))
+	, _cache()
+	, _predicate(std::move(predicate)) {}
+
+	// Pointer and Length Constructor: no strlen, so the range may hold NULs or sit inside a larger buffer
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(const char* str, std::size_t length)
+	requires std::constructible_from<Pred, accept_all>
+	: _ptr(str)
+	, _length(length)
+	, _cache()
+	, _predicate(accept_all{}) {}
+
+	// Pointer and Length with Predicate Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(const char* str,
+	                                                             std::size_t length,
+	                                                             detail::predicate_param<Pred> predicate)
+	: _ptr(str)
+	, _length(length)
+	, _cache()
+	, _predicate(std::move(predicate)) {}
+
+	// Implicit String View Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(std::string_view str)
+	requires std::constructible_from<Pred, accept_all>
+	: _ptr(str.data())
+	, _length(str.size())
+	, _cache()
+	, _predicate(accept_all{}) {}
+
+	// String View with Predicate Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(std::string_view str,
+	                                                             detail::predicate_param<Pred> predicate)
+	: _ptr(str.data())
+	, _length(str.size())
+	, _cache()
+	, _predicate(std::move(predicate)) {}
+
+	// Shared Predicate Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(const char* str,
+	                                                             std::size_t length,
+	                                                             const detail::predicate_holder<Pred>& predicate)
+	requires(!std::same_as<Pred, filter>)
+	: _ptr(str)
+	, _length(length)
+	, _cache()
+	, _predicate(predicate) {}
+
+	// Converting Constructor
+	template<typename Pred>
+	template<typename Other>
+	requires(!std::same_as<Other, Pred>) && std::constructible_from<Pred, const Other&>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(const basic_filtered_string_view<Other>& other)
+	: _ptr(other._ptr)
+	, _length(other._length)
+	, _cache(other._cache)
+	, _predicate(Pred(other.predicate())) {}
+
+	// Copy Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(const basic_filtered_string_view& other) noexcept(
+	    std::is_nothrow_copy_constructible_v<holder>)
+	: _ptr(other._ptr)
+	, _length(other._length)
+	, _cache(other._cache)
+	, _predicate(other._predicate) {}
+
+	// Move Constructor: the predicate is moved, never copied. The moved-from view is empty; a moved-from filter
+	// holder is the accept-all one, other predicates are left in their own moved-from state.
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::basic_filtered_string_view(basic_filtered_string_view&& other) noexcept(
+	    std::is_nothrow_move_constructible_v<holder>)
+	: _ptr(other._ptr)
+	, _length(other._length)
+	, _cache(std::move(other._cache))
+	, _predicate(std::move(other._predicate)) {
+		other._ptr = nullptr;
+		other._length = 0;
+		other._cache.remember(0);
+	}
+
+	// Copy Assignment Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::operator=(const basic_filtered_string_view& other) noexcept(
+	    std::is_nothrow_copy_assignable_v<holder>) -> basic_filtered_string_view&
+	requires std::is_copy_assignable_v<holder>
+	{
+		if (this != &other) {
+			_ptr = other._ptr;
+			_length = other._length;
+			_cache = other._cache;
+			_predicate = other._predicate;
+		}
+		return *this;
+	}
+
+	// Move Assignment Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::operator=(basic_filtered_string_view&& other) noexcept(
+	    std::is_nothrow_move_assignable_v<holder>) -> basic_filtered_string_view&
+	requires std::is_move_assignable_v<holder>
+	{
+		if (this != &other) {
+			_ptr = other._ptr;
+			_length = other._length;
+			_cache = std::move(other._cache);
+			_predicate = std::move(other._predicate);
+
+			other._ptr = nullptr;
+			other._length = 0;
+			other._cache.remember(0);
+		}
+		return *this;
+	}
+
+	// Subscript Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::operator[](int n) -> const char& {
+		if (n >= 0 && static_cast<std::size_t>(n) < ensure_index()) {
+			return *locate(static_cast<std::size_t>(n));
+		}
+
+		static const char default_char = '\0';
+		return default_char;
+	}
+
+	// String Type Conversion Operator
+	// One pass: left-pack into a buffer sized for the unfiltered length, then trim (and give memory back
+	// when most of it went unused). The count falls out of the pass, so it also fills the size cache.
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::operator std::string() const {
+		const auto scan = detail::scanner<Pred>(predicate());
+		if (scan.accepts_all()) {
+			return std::string(_ptr, _length);
+		}
+		auto result = std::string();
+#if defined(__cpp_lib_string_resize_and_overwrite)
+		// The kernel writes straight into the uninitialised buffer, so the output is not zero-filled first
+		result.resize_and_overwrite(_length, [this, &scan](char* out, std::size_t) {
+			return scan.compress(_ptr, _ptr + _length, out);
+		});
+#else
+		result.resize(_length);
+		result.resize(scan.compress(_ptr, _ptr + _length, result.data()));
+#endif
+		const std::size_t kept = result.size();
+		_cache.remember(kept);
+		if (result.capacity() > 2 * kept) {
+			result.shrink_to_fit();
+		}
+		return result;
+	}
+
+	// at Member Function
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::at(int index) -> const char& {
+		if (index < 0 || static_cast<std::size_t>(index) >= ensure_index()) {
+			throw std::domain_error("filtered_string_view::at(" + std::to_string(index) + "): invalid index");
+		}
+		return *locate(static_cast<std::size_t>(index));
+	}
+
+	// size Member Function
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::size() const -> std::size_t {
+		auto result = _cache.size();
+		if (result == detail::view_cache::unknown_size) {
+			result = detail::scanner<Pred>(predicate()).count(_ptr, _ptr + _length);
+			_cache.remember(result);
+		}
+		return result;
+	}
+
+	// find Member Function: filtered index of the first occurrence of needle at or after pos, or npos
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::find(std::string_view needle, std::size_t pos) const -> std::size_t {
+		const auto result = find_match(needle, pos);
+		return result ? result->index : npos;
+	}
+
+	// rfind Member Function: filtered index of the last occurrence of needle starting at or before pos, or npos
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::rfind(std::string_view needle, std::size_t pos) const -> std::size_t {
+		const auto result = rfind_match(needle, pos);
+		return result ? result->index : npos;
+	}
+
+	// find_match Member Function
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::find_match(std::string_view needle, std::size_t pos) const
+	    -> std::optional<match> {
+		if (pos == 0) {
+			return search_forward(needle, _ptr, 0);
+		}
+		const auto total = size();
+		if (pos > total) {
+			return std::nullopt;
+		}
+		return search_forward(needle, pos < total ? locate(pos) : _ptr + _length, pos);
+	}
+
+	// rfind_match Member Function
+	// Only the first min(pos, size() - needle.size()) + needle.size() characters can hold such a match.
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::rfind_match(std::string_view needle, std::size_t pos) const
+	    -> std::optional<match> {
+		const auto total = size();
+		if (needle.size() > total) {
+			return std::nullopt;
+		}
+		const auto end_index = std::min(pos, total - needle.size()) + needle.size();
+		return search_backward(needle, end_index < total ? locate(end_index) : _ptr + _length, end_index);
+	}
+
+	// contains Member Function
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::contains(std::string_view needle) const -> bool {
+		return search_forward(needle, _ptr, 0).has_value();
+	}
+
+	// starts_with Member Function: compares run by run and stops at the first difference
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::starts_with(std::string_view prefix) const -> bool {
+		auto matched = std::size_t{0};
+		auto equal = true;
+		for_each_run([&prefix, &matched, &equal](std::string_view run) {
+			const auto n = std::min(run.size(), prefix.size() - matched);
+			equal = run.substr(0, n) == prefix.substr(matched, n);
+			matched += n;
+			return equal && matched < prefix.size();
+		});
+		return equal && matched == prefix.size();
+	}
+
+	// ends_with Member Function
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::ends_with(std::string_view suffix) const -> bool {
+		auto it = rbegin();
+		const auto stop = rend();
+		for (auto c = suffix.rbegin(); c != suffix.rend(); ++c, ++it) {
+			if (it == stop || *it != *c) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Forward Search from raw position start, whose filtered index is index
+	// An accept-all view is its raw window and goes straight to the substring kernel. Otherwise blocks of
+	// the window are compressed (with the vector kernel for a char_set) and searched, carrying the last
+	// needle.size() - 1 characters over so that matches across blocks are found too.
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::search_forward(std::string_view needle,
+	                                                      const char* start,
+	                                                      std::size_t index) const -> std::optional<match> {
+		const auto scan = detail::scanner<Pred>(predicate());
+		const char* last = _ptr + _length;
+		if (needle.empty()) {
+			return match{index, static_cast<std::size_t>(start - _ptr)};
+		}
+		if (scan.accepts_all()) {
+			const char* hit = detail::search(start, last, needle);
+			if (hit == last) {
+				return std::nullopt;
+			}
+			return match{index + static_cast<std::size_t>(hit - start), static_cast<std::size_t>(hit - _ptr)};
+		}
+		if (!std::all_of(needle.begin(), needle.end(), std::cref(predicate()))) {
+			return std::nullopt;
+		}
+
+		auto buffer = detail::search_buffer(needle.size());
+		char* buf = buffer.data();
+		const auto keep_max = needle.size() - 1;
+		const auto block_length = static_cast<std::ptrdiff_t>(buffer.size() - keep_max);
+		auto carry = std::size_t{0};
+		for (const char* block = start; block != last;) {
+			const char* block_end = block + std::min(block_length, last - block);
+			const auto length = carry + scan.compress(block, block_end, buf + carry);
+			const char* hit = detail::search(buf, buf + length, needle);
+			if (hit != buf + length) {
+				const auto at = static_cast<std::size_t>(hit - buf);
+				const char* raw =
+				    at >= carry ? scan.nth(block, block_end, at - carry) : scan.nth_last(start, block, carry - at);
+				return match{index + at, static_cast<std::size_t>(raw - _ptr)};
+			}
+			const auto keep = std::min(length, keep_max);
+			std::memmove(buf, buf + length - keep, keep);
+			index += length - keep;
+			carry = keep;
+			block = block_end;
+		}
+		return std::nullopt;
+	}
+
+	// Backward Search ending at raw position end, whose filtered index is end_index
+	// Mirrors search_forward from the back; the carried characters are parked past the block area, out of
+	// reach of compress, and appended after each compressed block.
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::search_backward(std::string_view needle,
+	                                                       const char* end,
+	                                                       std::size_t end_index) const -> std::optional<match> {
+		const auto scan = detail::scanner<Pred>(predicate());
+		if (needle.empty()) {
+			return match{end_index, static_cast<std::size_t>(end - _ptr)};
+		}
+		if (scan.accepts_all()) {
+			const auto at = std::string_view(_ptr, static_cast<std::size_t>(end - _ptr)).rfind(needle);
+			return at == npos ? std::nullopt : std::optional<match>(match{at, at});
+		}
+		if (!std::all_of(needle.begin(), needle.end(), std::cref(predicate()))) {
+			return std::nullopt;
+		}
+
+		auto buffer = detail::search_buffer(needle.size());
+		char* buf = buffer.data();
+		const auto keep_max = needle.size() - 1;
+		const auto block_length = static_cast<std::ptrdiff_t>(buffer.size() - keep_max);
+		char* parked = buf + block_length;
+		auto carry = std::size_t{0};
+		for (const char* block_end = end; block_end != _ptr;) {
+			const char* block = block_end - std::min(block_length, block_end - _ptr);
+			const auto compressed = scan.compress(block, block_end, buf);
+			std::memmove(buf + compressed, parked, carry);
+			const auto length = compressed + carry;
+			const auto at = std::string_view(buf, length).rfind(needle);
+			const auto index = end_index - length;
+			if (at != npos) {
+				const char* raw =
+				    at < compressed ? scan.nth(block, block_end, at) : scan.nth(block_end, end, at - compressed);
+				return match{index + at, static_cast<std::size_t>(raw - _ptr)};
+			}
+			const auto keep = std::min(length, keep_max);
+			std::memmove(parked, buf, keep);
+			end_index = index + keep;
+			carry = keep;
+			block_end = block;
+		}
+		return std::nullopt;
+	}
+
+	// empty Member Function
+	// Without a cached size, stopping at the first accepted character beats counting them all.
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::empty() -> bool {
+		const auto known = _cache.size();
+		if (known != detail::view_cache::unknown_size) {
+			return known == 0;
+		}
+		const char* last = _ptr + _length;
+		return detail::scanner<Pred>(predicate()).find(_ptr, last) == last;
+	}
+
+	// data Member Function
+	template<typename Pred>
+	const char* basic_filtered_string_view<Pred>::data() const {
+		return _ptr;
+	}
+
+	// predicate Member Function
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::predicate() const -> const Pred& {
+		return _predicate.get();
+	}
+
+	// raw Member Function: the unfiltered window the view was built over
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::raw() const noexcept -> std::string_view {
+		return std::string_view(_ptr, _length);
+	}
+
+	// window Member Function: the view of raw().substr(offset, count) under the same predicate, which is
+	// shared with this view rather than copied
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::window(std::size_t offset, std::size_t count) const
+	    -> basic_filtered_string_view {
+		if (offset > _length) {
+			throw std::out_of_range("filtered_string_view::window(" + std::to_string(offset) + "): invalid offset");
+		}
+		return basic_filtered_string_view(_ptr + offset, std::min(count, _length - offset), _predicate);
+	}
+
+	// runs Member Function
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::runs() const -> run_range {
+		return run_range(_ptr, _ptr + _length, detail::scanner<Pred>(predicate()));
+	}
+
+	// for_each_run Member Function: calls back once per maximal accepted run, in order. A callback that
+	// returns bool stops the walk by returning false.
+	template<typename Pred>
+	template<typename Callback>
+	requires std::invocable<Callback&, std::string_view>
+	void basic_filtered_string_view<Pred>::for_each_run(Callback callback) const {
+		const auto scan = detail::scanner<Pred>(predicate());
+		const char* last = _ptr + _length;
+		for (const char* p = scan.find(_ptr, last); p != last;) {
+			const char* run_end = scan.find_not(p, last);
+			if constexpr (std::same_as<std::invoke_result_t<Callback&, std::string_view>, bool>) {
+				if (!callback(std::string_view(p, run_end))) {
+					return;
+				}
+			}
+			else {
+				callback(std::string_view(p, run_end));
+			}
+			p = scan.find(run_end, last);
+		}
+	}
+
+	// Build the Rank/Select Index on First Use, returning the filtered size
+	// Accept-all views map indices to positions directly and never need one.
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::ensure_index() -> std::size_t {
+		if (const auto* index = _cache.index()) {
+			return index->size();
+		}
+		if (detail::scanner<Pred>(predicate()).accepts_all()) {
+			return _length;
+		}
+		auto words = std::vector<std::uint64_t>((_length + 63) / 64);
+		for_each_run([this, &words](std::string_view run) {
+			const auto offset = static_cast<std::size_t>(run.data() - _ptr);
+			detail::set_bits(words, offset, offset + run.size());
+		});
+		return _cache.build(detail::rank_select(std::move(words))).size();
+	}
+
+	// Raw Position of the n-th Accepted Character (n < size()); scans when no index has been built
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::locate(std::size_t n) const -> const char* {
+		if (const auto* index = _cache.index()) {
+			return _ptr + index->select(n);
+		}
+		return detail::scanner<Pred>(predicate()).nth(_ptr, _ptr + _length, n);
+	}
+
+	// Run Range Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::run_range::run_range(const char* first,
+	                                                       const char* last,
+	                                                       detail::scanner<Pred> scan) noexcept
+	: _first(first)
+	, _last(last)
+	, _scan(scan) {}
+
+	// Run Range Begin Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::run_range::begin() const -> iterator {
+		return iterator(_scan.find(_first, _last), _last, _scan);
+	}
+
+	// Run Range End Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::run_range::end() const -> iterator {
+		return iterator(_last, _last, _scan);
+	}
+
+	// Run Iterator Default Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::run_range::iterator::iterator() noexcept
+	: _run(nullptr)
+	, _run_end(nullptr)
+	, _last(nullptr)
+	, _scan() {}
+
+	// Run Iterator Constructor, positioned at the start of a run (or at last)
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::run_range::iterator::iterator(const char* run,
+	                                                                 const char* last,
+	                                                                 detail::scanner<Pred> scan) noexcept
+	: _run(run)
+	, _run_end(run == last ? last : scan.find_not(run, last))
+	, _last(last)
+	, _scan(scan) {}
+
+	// Run Iterator Dereference Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::run_range::iterator::operator*() const -> value_type {
+		return std::string_view(_run, _run_end);
+	}
+
+	// Run Iterator Pre-Increment Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::run_range::iterator::operator++() -> iterator& {
+		_run = _scan.find(_run_end, _last);
+		_run_end = _run == _last ? _last : _scan.find_not(_run, _last);
+		return *this;
+	}
+
+	// Run Iterator Post-Increment Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::run_range::iterator::operator++(int) -> iterator {
+		iterator tmp = *this;
+		++*this;
+		return tmp;
+	}
+
+	// Run Iterator Equality Comparison Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::run_range::iterator::operator==(const iterator& other) const noexcept
+	    -> bool {
+		return _run == other._run;
+	}
+
+	// Same Buffer, Length and Predicate, so the Filtered Contents are Equal without Looking
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::same_window(const basic_filtered_string_view& other) const -> bool {
+		return _ptr == other._ptr && _length == other._length && detail::same_predicate(predicate(), other.predicate());
+	}
+
+	// Iterator Default Constructor
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::iter::iter() noexcept
+	: _first(nullptr)
+	, _last(nullptr)
+	, _ptr(nullptr)
+	, _scan() {}
+
+	// Iterator Constructor over [first, last), positioned at pos
+	template<typename Pred>
+	basic_filtered_string_view<Pred>::iter::iter(const char* first,
+	                                             const char* last,
+	                                             const char* pos,
+	                                             detail::scanner<Pred> scan) noexcept
+	: _first(first)
+	, _last(last)
+	, _ptr(pos)
+	, _scan(scan) {}
+
+	// Iterator Dereference Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::iter::operator*() const -> reference {
+		return *_ptr;
+	}
+
+	// Iterator Arrow Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::iter::operator->() const -> pointer {
+		return _ptr;
+	}
+
+	// Iterator Pre-Increment Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::iter::operator++() -> iter& {
+		advance();
+		return *this;
+	}
+
+	// Iterator Post-Increment Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::iter::operator++(int) -> iter {
+		iter tmp = *this;
+		advance();
+		return tmp;
+	}
+
+	// Iterator Pre-Decrement Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::iter::operator--() -> iter& {
+		retreat();
+		return *this;
+	}
+
+	// Iterator Post-Decrement Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::iter::operator--(int) -> iter {
+		iter tmp = *this;
+		retreat();
+		return tmp;
+	}
+
+	// Iterator Equality Comparison Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::iter::operator==(const iter& other) const noexcept -> bool {
+		return _ptr == other._ptr;
+	}
+
+	// Iterator Inequality Comparison Operator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::iter::operator!=(const iter& other) const noexcept -> bool {
+		return !(*this == other);
+	}
+
+	// Iterator Sentinel Comparison Operator: every iterator knows where its view ends
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::iter::operator==(std::default_sentinel_t) const noexcept -> bool {
+		return _ptr == _last;
+	}
+
+	// Advance Iterator to Next Valid Position
+	template<typename Pred>
+	void basic_filtered_string_view<Pred>::iter::advance() {
+		_ptr = _scan.find(_ptr + 1, _last);
+	}
+
+	// Retreat Iterator to Previous Valid Position
+	template<typename Pred>
+	void basic_filtered_string_view<Pred>::iter::retreat() {
+		_ptr = _scan.find_last(_first, _ptr);
+	}
+
+	// Begin Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::begin() const -> const_iterator {
+		const auto scan = detail::scanner<Pred>(predicate());
+		return const_iterator(_ptr, _ptr + _length, scan.find(_ptr, _ptr + _length), scan);
+	}
+
+	// End Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::end() const -> const_iterator {
+		return const_iterator(_ptr, _ptr + _length, _ptr + _length, detail::scanner<Pred>(predicate()));
+	}
+
+	// Constant Begin Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::cbegin() const -> const_iterator {
+		return begin();
+	}
+
+	// Constant End Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::cend() const -> const_iterator {
+		return end();
+	}
+
+	// Reverse Begin Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::rbegin() const -> const_reverse_iterator {
+		return const_reverse_iterator(end());
+	}
+
+	// Reverse End Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::rend() const -> const_reverse_iterator {
+		return const_reverse_iterator(begin());
+	}
+
+	// Constant Reverse Begin Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::crbegin() const -> const_reverse_iterator {
+		return rbegin();
+	}
+
+	// Constant Reverse End Iterator
+	template<typename Pred>
+	auto basic_filtered_string_view<Pred>::crend() const -> const_reverse_iterator {
+		return rend();
+	}
+
+	// Split View Constructor
+	template<typename Pred>
+	split_view<Pred>::split_view(basic_filtered_string_view<Pred> fsv, std::string_view tok)
+	: _fsv(std::move(fsv))
+	, _tok(tok) {}
+
+	// Split View Begin Iterator
+	// An empty delimiter or a view with nothing accepted yields the whole view as its only segment.
+	template<typename Pred>
+	auto split_view<Pred>::begin() const -> iterator {
+		const char* first = _fsv.data();
+		const char* last = first + _fsv.raw().size();
+		auto finder = detail::delimiter_finder(_tok);
+		if (_tok.empty() || detail::scanner<Pred>(_fsv.predicate()).find(first, last) == last) {
+			return iterator(this, first, last, finder);
+		}
+		const char* segment_end = finder.next(first, last);
+		return iterator(this, first, segment_end, finder);
+	}
+
+	// Split View End Iterator
+	template<typename Pred>
+	auto split_view<Pred>::end() const -> iterator {
+		return iterator();
+	}
+
+	// Split Iterator Default Constructor: the past-the-end iterator
+	template<typename Pred>
+	split_view<Pred>::iterator::iterator() noexcept
+	: _parent(nullptr)
+	, _segment(nullptr)
+	, _segment_end(nullptr)
+	, _finder()
+	, _done(true) {}
+
+	// Split Iterator Constructor
+	template<typename Pred>
+	split_view<Pred>::iterator::iterator(const split_view* parent,
+	                                     const char* segment,
+	                                     const char* segment_end,
+	                                     detail::delimiter_finder finder) noexcept
+	: _parent(parent)
+	, _segment(segment)
+	, _segment_end(segment_end)
+	, _finder(finder)
+	, _done(false) {}
+
+	// Split Iterator Dereference
+	template<typename Pred>
+	auto split_view<Pred>::iterator::operator*() const -> value_type {
+		const auto length = static_cast<std::size_t>(_segment_end - _segment);
+		return _parent->_fsv.window(static_cast<std::size_t>(_segment - _parent->_fsv.data()), length);
+	}
+
+	// Split Iterator Pre-Increment
+	// A delimiter that ends the window is followed by one empty segment before the end.
+	template<typename Pred>
+	auto split_view<Pred>::iterator::operator++() -> iterator& {
+		const auto& fsv = _parent->_fsv;
+		const char* last = fsv.data() + fsv.raw().size();
+		if (_segment_end == last) {
+			*this = iterator();
+		}
+		else {
+			_segment = _segment_end + _parent->_tok.size();
+			_segment_end = _finder.next(_segment, last);
+		}
+		return *this;
+	}
+
+	// Split Iterator Post-Increment
+	template<typename Pred>
+	auto split_view<Pred>::iterator::operator++(int) -> iterator {
+		auto copy = *this;
+		++*this;
+		return copy;
+	}
+
+	// Split Iterator Equality
+	template<typename Pred>
+	auto split_view<Pred>::iterator::operator==(const iterator& other) const noexcept -> bool {
+		return _done == other._done && _segment == other._segment;
+	}
+
+	// Split Function
+	template<typename Pred>
+	auto split(const basic_filtered_string_view<Pred>& fsv, const filtered_string_view& tok)
+	    -> std::vector<basic_filtered_string_view<Pred>> {
+		auto segments = split_range(fsv, tok.raw());
+		return std::vector<basic_filtered_string_view<Pred>>(segments.begin(), segments.end());
+	}
+
+	// Parallel Split Function: the same segments as split, with the delimiters found across threads
+	template<typename Pred>
+	auto split_parallel(const basic_filtered_string_view<Pred>& fsv,
+	                    const filtered_string_view& tok,
+	                    std::size_t threads) -> std::vector<basic_filtered_string_view<Pred>> {
+		const char* first = fsv.data();
+		const char* last = first + fsv.raw().size();
+		const auto delim = tok.raw();
+		if (delim.empty() || detail::scanner<Pred>(fsv.predicate()).find(first, last) == last) {
+			return {fsv};
+		}
+
+		const auto hits = detail::find_delimiters(first, last, delim, threads);
+		auto result = std::vector<basic_filtered_string_view<Pred>>();
+		result.reserve(hits.size() + 1);
+		const char* segment_start = first;
+		for (const char* hit : hits) {
+			result.push_back(fsv.window(static_cast<std::size_t>(segment_start - first),
+			                            static_cast<std::size_t>(hit - segment_start)));
+			segment_start = hit + delim.size();
+		}
+		result.push_back(fsv.window(static_cast<std::size_t>(segment_start - first),
+		                            static_cast<std::size_t>(last - segment_start)));
+		return result;
+	}
+
+	// Lazy Split Function
+	template<typename Pred>
+	auto split_range(const basic_filtered_string_view<Pred>& fsv, std::string_view tok) -> split_view<Pred> {
+		return split_view<Pred>(fsv, tok);
+	}
+
+	// Split If View Constructor
+	template<typename Pred, typename Delim>
+	split_if_view<Pred, Delim>::split_if_view(basic_filtered_string_view<Pred> fsv, Delim delim, split_mode mode)
+	: _fsv(std::move(fsv))
+	, _delim(std::move(delim))
+	, _mode(mode) {}
+
+	// Split If View Begin Iterator
+	template<typename Pred, typename Delim>
+	auto split_if_view<Pred, Delim>::begin() const -> iterator {
+		const char* first = _fsv.data();
+		const char* last = first + _fsv.raw().size();
+		if (_mode == split_mode::collapse) {
+			first = detail::scanner<Delim>(_delim).find_not(first, last);
+			if (first == last) {
+				return end();
+			}
+		}
+		return iterator(this, first);
+	}
+
+	// Split If View End Iterator
+	template<typename Pred, typename Delim>
+	auto split_if_view<Pred, Delim>::end() const -> iterator {
+		return iterator();
+	}
+
+	// Split If Iterator Default Constructor: the past-the-end iterator
+	template<typename Pred, typename Delim>
+	split_if_view<Pred, Delim>::iterator::iterator() noexcept
+	: _parent(nullptr)
+	, _segment(nullptr)
+	, _segment_end(nullptr)
+	, _scan() {}
+
+	// Split If Iterator Constructor
+	template<typename Pred, typename Delim>
+	split_if_view<Pred, Delim>::iterator::iterator(const split_if_view* parent, const char* segment) noexcept
+	: _parent(parent)
+	, _segment(segment)
+	, _segment_end(nullptr)
+	, _scan(parent->_delim) {
+		_segment_end = _scan.find(segment, parent->_fsv.data() + parent->_fsv.raw().size());
+	}
+
+	// Split If Iterator Dereference
+	template<typename Pred, typename Delim>
+	auto split_if_view<Pred, Delim>::iterator::operator*() const -> value_type {
+		const auto length = static_cast<std::size_t>(_segment_end - _segment);
+		return _parent->_fsv.window(static_cast<std::size_t>(_segment - _parent->_fsv.data()), length);
+	}
+
+	// Split If Iterator Pre-Increment
+	template<typename Pred, typename Delim>
+	auto split_if_view<Pred, Delim>::iterator::operator++() -> iterator& {
+		const auto& fsv = _parent->_fsv;
+		const char* last = fsv.data() + fsv.raw().size();
+		if (_segment_end == last) {
+			*this = iterator();
+			return *this;
+		}
+		const char* next = _segment_end + 1;
+		if (_parent->_mode == split_mode::collapse) {
+			next = _scan.find_not(next, last);
+			if (next == last) {
+				*this = iterator();
+				return *this;
+			}
+		}
+		_segment = next;
+		_segment_end = _scan.find(next, last);
+		return *this;
+	}
+
+	// Split If Iterator Post-Increment
+	template<typename Pred, typename Delim>
+	auto split_if_view<Pred, Delim>::iterator::operator++(int) -> iterator {
+		auto copy = *this;
+		++*this;
+		return copy;
+	}
+
+	// Split If Iterator Equality
+	template<typename Pred, typename Delim>
+	auto split_if_view<Pred, Delim>::iterator::operator==(const iterator& other) const noexcept -> bool {
+		return _parent == other._parent && _segment == other._segment;
+	}
+
+	// Variadic Compose Function: like the vector form, the result filters fsv's raw window by the operands
+	// alone, but they are fused at compile time instead of each being called through a std::function
+	template<typename Pred, typename... Preds>
+	requires(sizeof...(Preds) > 0) && (std::predicate<const Preds&, const char&> && ...)
+	auto compose(const basic_filtered_string_view<Pred>& fsv, Preds... preds)
+	    -> basic_filtered_string_view<detail::composed_predicate<Preds...>> {
+		if constexpr (std::same_as<detail::composed_predicate<Preds...>, char_set>) {
+			return basic_filtered_string_view<char_set>(fsv.raw(), (preds & ...));
+		}
+		else {
+			auto fused = conjunction<Preds...>(std::move(preds)...);
+			return basic_filtered_string_view<conjunction<Preds...>>(fsv.raw(), std::move(fused));
+		}
+	}
+
+	// Split If Function
+	template<typename Pred, typename Delim>
+	requires std::predicate<const Delim&, const char&>
+	auto split_if(const basic_filtered_string_view<Pred>& fsv, Delim delim, split_mode mode)
+	    -> split_if_view<Pred, Delim> {
+		return split_if_view<Pred, Delim>(fsv, std::move(delim), mode);
+	}
+
+	// Substring Function
+	template<typename Pred>
+	auto substr(const basic_filtered_string_view<Pred>& fsv, int pos, int count) -> basic_filtered_string_view<Pred> {
+		const std::size_t total_size = fsv.size();
+		const char* fsv_end = fsv._ptr + fsv._length;
+		if (pos < 0 || static_cast<std::size_t>(pos) >= total_size) {
+			return fsv.window(fsv._length, 0);
+		}
+		const auto first = static_cast<std::size_t>(pos);
+		const std::size_t rest = total_size - first;
+		const std::size_t rcount = (count <= 0) ? rest : std::min(static_cast<std::size_t>(count), rest);
+		const char* substr_start = fsv.locate(first);
+		// Without an index the end is found by carrying on from the start, not by rescanning from _ptr
+		const char* substr_end = fsv_end;
+		if (rcount < rest) {
+			substr_end = fsv._cache.index() != nullptr
+			                 ? fsv.locate(first + rcount)
+			                 : detail::scanner<Pred>(fsv.predicate()).nth(substr_start, fsv_end, rcount);
+		}
+
+		auto result = fsv.window(static_cast<std::size_t>(substr_start - fsv._ptr),
+		                         static_cast<std::size_t>(substr_end - substr_start));
+		result._cache.remember(rcount);
+		return result;
+	}
+
+	extern template class basic_filtered_string_view<filter>;
+	extern template auto split(const filtered_string_view& fsv, const filtered_string_view& tok)
+	    -> std::vector<filtered_string_view>;
+	extern template auto substr(const filtered_string_view& fsv, int pos, int count) -> filtered_string_view;
 
 } // namespace fsv
 
+namespace std::ranges {
+	// A view is cheap to copy and never owns its characters. Its iterators outlive it when the predicate
+	// is stateless, since they then hold nothing of the view's; otherwise they point at the predicate it
+	// stores.
+	template<typename Pred>
+	inline constexpr bool enable_view<fsv::basic_filtered_string_view<Pred>> = true;
+	template<typename Pred>
+	inline constexpr bool enable_borrowed_range<fsv::basic_filtered_string_view<Pred>> =
+	    fsv::detail::stateless_predicate<Pred>;
+} // namespace std::ranges
+
+namespace std {
+	// Hashes the filtered characters exactly as std::hash<std::string_view> hashes the same text, so a view
+	// and its materialised string land in the same bucket. Accept-all views hash their window in place;
+	// otherwise the runs are streamed through the library's own string hash where it can be reproduced,
+	// and gathered into a string where it cannot.
+	template<typename Pred>
+	struct hash<fsv::basic_filtered_string_view<Pred>> {
+		auto operator()(const fsv::basic_filtered_string_view<Pred>& view) const -> std::size_t;
+	};
+
+	// Hash Call Operator
+	template<typename Pred>
+	auto
+	hash<fsv::basic_filtered_string_view<Pred>>::operator()(const fsv::basic_filtered_string_view<Pred>& view) const
+	    -> std::size_t {
+		if (fsv::detail::scanner<Pred>(view.predicate()).accepts_all()) {
+			return hash<string_view>{}(view.raw());
+		}
+		if constexpr (fsv::detail::string_hash_stream::reproduces_std) {
+			auto stream = fsv::detail::string_hash_stream(view.size());
+			view.for_each_run([&stream](string_view run) { stream.update(run); });
+			return stream.result();
+		}
+		else {
+			return hash<string>{}(static_cast<string>(view));
+		}
+	}
+} // namespace std
+
 #endif // COMP6771_ASS2_FSV_H
@@ -1,8 +1,64 @@
 #include "./filtered_string_view.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <catch2/catch.hpp>
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <random>
+#include <ranges>
 #include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+	// Every allocation made through the global operator new, so a test can check that a path makes none
+	std::atomic<std::size_t> allocations{0};
+
+	auto counted_malloc(std::size_t size) noexcept -> void* {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		return std::malloc(size == 0 ? 1 : size);
+	}
+} // namespace
+
+// Every unaligned form is replaced, so that each allocation is freed by the matching function. They stay out
+// of line: inlined into one another's callers, GCC mistakes the malloc and free pairs for a mismatch.
+__attribute__((noinline)) auto operator new(std::size_t size) -> void* {
+	if (void* p = counted_malloc(size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+__attribute__((noinline)) auto operator new[](std::size_t size) -> void* {
+	return operator new(size);
+}
+__attribute__((noinline)) auto operator new(std::size_t size, const std::nothrow_t&) noexcept -> void* {
+	return counted_malloc(size);
+}
+__attribute__((noinline)) auto operator new[](std::size_t size, const std::nothrow_t&) noexcept -> void* {
+	return counted_malloc(size);
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+	std::free(p);
+}
+__attribute__((noinline)) void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+__attribute__((noinline)) void operator delete[](void* p, std::size_t) noexcept {
+	std::free(p);
+}
+__attribute__((noinline)) void operator delete(void* p, const std::nothrow_t&) noexcept {
+	std::free(p);
+}
+__attribute__((noinline)) void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	std::free(p);
+}
 
 TEST_CASE("Default Constructor") {
 	fsv::filtered_string_view sv;
@@ -303,3 +359,672 @@ TEST_CASE("TEST 1") {
 	auto sv = fsv::filtered_string_view{"Sled Dog", is_upper};
 	std::cout << fsv::substr(sv, 0, 2);
 }
+
+TEST_CASE("Statically Typed Predicate") {
+	auto is_digit = [](const char& c) { return c >= '0' && c <= '9'; };
+	auto sv = fsv::basic_filtered_string_view{"a1b2c3", is_digit};
+	STATIC_REQUIRE(std::is_same_v<decltype(sv)::predicate_type, decltype(is_digit)>);
+	REQUIRE(sv.size() == 3);
+	REQUIRE(static_cast<std::string>(sv) == "123");
+	REQUIRE(sv.at(2) == '3');
+
+	auto erased = fsv::filtered_string_view{sv};
+	REQUIRE(erased.data() == sv.data());
+	REQUIRE(erased == "123");
+
+	// Capturing lambdas cannot be assigned, yet views over them can: the predicate is rebuilt in place
+	const auto skip = ',';
+	auto not_skip = [skip](const char& c) { return c != skip; };
+	using capturing = fsv::basic_filtered_string_view<decltype(not_skip)>;
+	STATIC_REQUIRE(!std::is_copy_assignable_v<decltype(not_skip)>);
+	STATIC_REQUIRE(std::is_copy_assignable_v<capturing>);
+	STATIC_REQUIRE(std::is_nothrow_move_assignable_v<capturing>);
+	STATIC_REQUIRE(std::movable<capturing>);
+	auto v = fsv::basic_filtered_string_view{"a,b,,c", not_skip};
+	auto w = fsv::basic_filtered_string_view{"x", not_skip};
+	w = v;
+	REQUIRE(static_cast<std::string>(w) == "abc");
+	w = fsv::substr(v, 1);
+	REQUIRE(static_cast<std::string>(w) == "bc");
+
+	auto parts = fsv::split(v, ",");
+	REQUIRE(parts.size() == 4);
+	parts.erase(parts.begin());
+	REQUIRE(parts.size() == 3);
+	REQUIRE(parts[0].raw() == "b");
+	REQUIRE(parts[2].raw() == "c");
+
+	// A capture whose copy can throw is copied before the old one is destroyed
+	auto in_word = [word = std::string("ab")](const char& c) { return word.find(c) != std::string::npos; };
+	using owning = fsv::basic_filtered_string_view<decltype(in_word)>;
+	STATIC_REQUIRE(!std::is_nothrow_copy_assignable_v<owning>);
+	auto x = fsv::basic_filtered_string_view{"abc", in_word};
+	auto y = fsv::basic_filtered_string_view{"bcd", in_word};
+	y = x;
+	REQUIRE(static_cast<std::string>(y) == "ab");
+}
+
+TEST_CASE("Random Access Index") {
+	auto text = std::string{};
+	for (int i = 0; i < 2000; ++i) {
+		text += static_cast<char>('a' + i % 26);
+	}
+	auto sv = fsv::filtered_string_view{text, [](const char& c) { return c == 'a' || c == 'z'; }};
+	REQUIRE(sv.size() == 153);
+	for (int i = 0; i < 153; ++i) {
+		REQUIRE(sv[i] == (i % 2 == 0 ? 'a' : 'z'));
+	}
+	REQUIRE(sv[153] == '\0');
+	REQUIRE(sv[-1] == '\0');
+	REQUIRE(sv.at(152) == 'a');
+	REQUIRE_THROWS_WITH(sv.at(153), "filtered_string_view::at(153): invalid index");
+
+	const auto copy = sv;
+	REQUIRE(copy.size() == 153);
+	REQUIRE(fsv::substr(copy, 10, 3) == "aza");
+}
+
+TEST_CASE("size Is Cached Across Copies and Moves") {
+	auto calls = 0;
+	auto counting = [&calls](const char& c) {
+		++calls;
+		return c != ' ';
+	};
+	auto sv = fsv::filtered_string_view{"a b c d", counting};
+	REQUIRE(sv.size() == 4);
+	REQUIRE(calls == 7);
+
+	REQUIRE(sv.size() == 4);
+	REQUIRE(!sv.empty());
+	const auto copy = sv;
+	REQUIRE(copy.size() == 4);
+	auto moved = fsv::filtered_string_view{std::move(sv)};
+	REQUIRE(moved.size() == 4);
+	REQUIRE(sv.size() == 0);
+	REQUIRE(calls == 7);
+}
+
+TEST_CASE("Accepted Runs") {
+	auto sv = fsv::filtered_string_view{"  aa bb  c ", [](const char& c) { return c != ' '; }};
+	auto runs = std::vector<std::string_view>{};
+	for (auto run : sv.runs()) {
+		runs.push_back(run);
+	}
+	REQUIRE(runs == std::vector<std::string_view>{"aa", "bb", "c"});
+	REQUIRE(runs[1].data() == sv.data() + 5);
+
+	auto visited = std::string{};
+	sv.for_each_run([&visited](std::string_view run) { visited.append(run).push_back('|'); });
+	REQUIRE(visited == "aa|bb|c|");
+
+	auto none = fsv::filtered_string_view{"xyz", [](const char&) { return false; }};
+	REQUIRE(none.runs().begin() == none.runs().end());
+	auto all = fsv::filtered_string_view{"xyz"};
+	REQUIRE(std::distance(all.runs().begin(), all.runs().end()) == 1);
+}
+
+TEST_CASE("String Conversion Fills the size Cache") {
+	auto calls = 0;
+	auto sv = fsv::filtered_string_view{"hello world", [&calls](const char& c) {
+		                                    ++calls;
+		                                    return c != 'o';
+	                                    }};
+	REQUIRE(static_cast<std::string>(sv) == "hell wrld");
+	REQUIRE(calls == 11);
+	REQUIRE(sv.size() == 9);
+	REQUIRE(calls == 11);
+}
+
+TEST_CASE("Streaming Comparison") {
+	auto no_digits = [](const char& c) { return c < '0' || c > '9'; };
+	auto const a = fsv::filtered_string_view{"ab1c2d", no_digits};
+	auto const b = fsv::filtered_string_view{"a9bcd", no_digits};
+	auto const c = fsv::filtered_string_view{"abc"};
+	REQUIRE(a == b);
+	REQUIRE((a <=> b) == std::strong_ordering::equal);
+	REQUIRE(c < a);
+	REQUIRE(a > c);
+	REQUIRE(fsv::filtered_string_view{"abd"} > a);
+	REQUIRE(fsv::filtered_string_view{""} < c);
+	REQUIRE(fsv::filtered_string_view{"\xFF"} > c);
+
+	static auto calls = 0;
+	auto const counted = fsv::basic_filtered_string_view{"same window", [](const char&) { return ++calls > 0; }};
+	auto const copy = counted;
+	REQUIRE(copy == counted);
+	REQUIRE((copy <=> counted) == std::strong_ordering::equal);
+	REQUIRE(calls == 0);
+
+	auto const sized_lhs = fsv::filtered_string_view{"xxxx"};
+	auto const sized_rhs = fsv::filtered_string_view{"xxx"};
+	REQUIRE(sized_lhs.size() != sized_rhs.size());
+	REQUIRE(sized_lhs != sized_rhs);
+}
+
+TEST_CASE("Output Stream Writes Whole Runs") {
+	struct counting_buf : std::stringbuf {
+		int writes = 0;
+
+	 protected:
+		auto xsputn(const char* s, std::streamsize n) -> std::streamsize override {
+			++writes;
+			return std::stringbuf::xsputn(s, n);
+		}
+	};
+
+	auto buf = counting_buf{};
+	auto os = std::ostream{&buf};
+	os << fsv::filtered_string_view{"an accept-all view"};
+	REQUIRE(buf.str() == "an accept-all view");
+	REQUIRE(buf.writes == 1);
+
+	os << fsv::filtered_string_view{"|aa##bbb#c", [](const char& c) { return c != '#'; }};
+	REQUIRE(buf.str() == "an accept-all view|aabbbc");
+	REQUIRE(buf.writes == 4);
+
+	auto bad = std::ostringstream{};
+	bad.setstate(std::ios_base::failbit);
+	bad << fsv::filtered_string_view{"ignored"};
+	REQUIRE(bad.str().empty());
+}
+
+TEST_CASE("Explicit Length and Embedded NULs") {
+	const char buffer[] = {'a', '\0', 'b', ',', 'c', 'X', 'X'};
+	auto sv = fsv::filtered_string_view{buffer, 5};
+	REQUIRE(sv.size() == 5);
+	REQUIRE(sv.raw() == std::string_view(buffer, 5));
+	REQUIRE(static_cast<std::string>(sv) == std::string("a\0b,c", 5));
+
+	auto no_nul = fsv::filtered_string_view{std::string_view(buffer, 5), [](const char& c) { return c != '\0'; }};
+	REQUIRE(no_nul == "ab,c");
+
+	auto parts = fsv::split(sv, ",");
+	REQUIRE(parts.size() == 2);
+	REQUIRE(parts[0] == fsv::filtered_string_view{std::string_view("a\0b", 3)});
+	REQUIRE(parts[1] == "c");
+
+	REQUIRE(fsv::substr(sv, 2) == "b,c");
+	REQUIRE(fsv::compose(sv, {[](const char& c) { return c != ','; }}).size() == 4);
+
+	auto typed = fsv::basic_filtered_string_view{buffer, 7U, fsv::char_set{"X"}};
+	REQUIRE(typed.size() == 2);
+}
+
+TEST_CASE("Slices Keep the Original Predicate") {
+	auto is_upper = [](const char& c) { return std::isupper(static_cast<unsigned char>(c)) != 0; };
+	auto text = std::string("aBcD-eFgH-iJ");
+	auto sv = fsv::basic_filtered_string_view{text, is_upper};
+
+	auto parts = fsv::split(sv, "-");
+	STATIC_REQUIRE(std::same_as<decltype(parts)::value_type, decltype(sv)>);
+	REQUIRE(parts.size() == 3);
+	REQUIRE(static_cast<std::string>(parts[1]) == "FH");
+	REQUIRE(parts[1].raw() == "eFgH");
+
+	auto nested = fsv::substr(fsv::substr(sv, 1, 4), 1, 2);
+	REQUIRE(static_cast<std::string>(nested) == "FH");
+	REQUIRE(nested.size() == 2);
+
+	// The slice does not refer back to the view it was cut from
+	auto detached = [&text] {
+		auto temporary = fsv::filtered_string_view{text, fsv::char_set{"BDFHJ"}};
+		return fsv::substr(temporary, 2);
+	}();
+	REQUIRE(detached == "FHJ");
+	REQUIRE(detached.predicate().target<fsv::char_set>() != nullptr);
+
+	REQUIRE(fsv::substr(sv, 9).empty());
+
+	// Without an index the scan for the end resumes at the start rather than at the front of the view:
+	// nine raw characters up to 'H', with only the start 'D' tested twice
+	auto calls = 0;
+	auto counted = fsv::basic_filtered_string_view{text, [&calls, is_upper](const char& c) {
+		                                               ++calls;
+		                                               return is_upper(c);
+	                                               }};
+	REQUIRE(counted.size() == 5);
+	calls = 0;
+	const auto slice = fsv::substr(counted, 1, 2);
+	REQUIRE(calls <= 10);
+	REQUIRE(static_cast<std::string>(slice) == "DF");
+}
+
+TEST_CASE("Compact Layout Shares the Predicate") {
+	// Pointer, length and the size/index word, plus one pointer for a type-erased predicate
+	STATIC_REQUIRE(sizeof(fsv::filtered_string_view) == 4 * sizeof(void*));
+	STATIC_REQUIRE(sizeof(fsv::basic_filtered_string_view<fsv::accept_all>) == 3 * sizeof(void*));
+
+	auto calls = 0;
+	const auto text = std::string("one,two,three");
+	auto counting = [&calls](const char& c) {
+		++calls;
+		return c != 'e';
+	};
+	auto sv = fsv::filtered_string_view{text, counting};
+	auto parts = fsv::split(sv, ",");
+	REQUIRE(parts.size() == 3);
+	REQUIRE(&parts[0].predicate() == &sv.predicate());
+	REQUIRE(&fsv::substr(sv, 2).predicate() == &sv.predicate());
+	REQUIRE(static_cast<std::string>(parts[2]) == "thr");
+
+	// Copies share the predicate, so a copy is recognised as the same window without comparing
+	const auto copy = sv;
+	calls = 0;
+	REQUIRE(copy == sv);
+	REQUIRE(calls == 0);
+
+	REQUIRE(sv.window(4, 3).raw() == "two");
+	REQUIRE(sv.window(8, 100).raw() == "three");
+	REQUIRE(sv.window(13, 1).raw().empty());
+	REQUIRE_THROWS_AS(sv.window(14, 0), std::out_of_range);
+	REQUIRE(&sv.window(0, 3).predicate() == &sv.predicate());
+
+	const auto plain = fsv::filtered_string_view{text};
+	REQUIRE(plain.predicate().target<fsv::accept_all>() != nullptr);
+	REQUIRE(plain.window(4, 3) == "two");
+}
+
+TEST_CASE("Stateless Filters Do Not Allocate") {
+	const auto text = std::string("a-b-c");
+	const auto not_dash = [](const char& c) { return c != '-'; };
+	bool (*is_letter)(const char&) = [](const char& c) { return c >= 'a' && c <= 'z'; };
+	// The first view over a function pointer enters it in the table; the second is the one measured
+	const auto first = fsv::filtered_string_view{text, is_letter};
+
+	const auto before = allocations.load();
+	std::size_t sizes = 0;
+	{
+		const auto lambda = fsv::filtered_string_view{text, not_dash};
+		const auto another = fsv::filtered_string_view{std::string_view(text), [](const char& c) { return c != 'b'; }};
+		const auto function = fsv::filtered_string_view{text.c_str(), is_letter};
+		const auto copy = lambda;
+		sizes = lambda.size() + another.size() + function.size() + copy.size() + fsv::substr(copy, 1).size();
+	}
+	const auto made = allocations.load() - before;
+	REQUIRE(made == 0);
+	REQUIRE(sizes == 3 + 4 + 3 + 3 + 2);
+
+	// Every view over one stateless type or one function shares the same permanent copy
+	const auto lambda = fsv::filtered_string_view{text, not_dash};
+	REQUIRE(&fsv::filtered_string_view{"x", not_dash}.predicate() == &lambda.predicate());
+	REQUIRE(&fsv::filtered_string_view{"x", is_letter}.predicate() == &first.predicate());
+	REQUIRE(fsv::filtered_string_view{text, fsv::accept_all{}}.predicate().target<fsv::accept_all>() != nullptr);
+
+	// Captured state still gets a counted copy of its own
+	const auto bound = 'b';
+	const auto before_stateful = allocations.load();
+	const auto stateful = fsv::filtered_string_view{text, [bound](const char& c) { return c >= bound; }};
+	REQUIRE(allocations.load() > before_stateful);
+	REQUIRE(stateful == "bc");
+}
+
+TEST_CASE("Moves Transfer the Predicate Without Copying") {
+	struct counted {
+		int* copies;
+		std::vector<char> rejected;
+
+		counted(int* count, std::vector<char> chars)
+		: copies(count)
+		, rejected(std::move(chars)) {}
+		counted(const counted& other)
+		: copies(other.copies)
+		, rejected(other.rejected) {
+			++*copies;
+		}
+		counted(counted&&) noexcept = default;
+		auto operator=(const counted&) -> counted& = default;
+		auto operator=(counted&&) noexcept -> counted& = default;
+		~counted() = default;
+
+		auto operator()(const char& c) const -> bool {
+			return std::find(rejected.begin(), rejected.end(), c) == rejected.end();
+		}
+	};
+	auto copies = 0;
+	const auto text = std::string("a,b;c");
+
+	auto typed = fsv::basic_filtered_string_view{text, counted(&copies, {',', ';'})};
+	auto moved = std::move(typed);
+	REQUIRE(copies == 0);
+	REQUIRE(static_cast<std::string>(moved) == "abc");
+	REQUIRE(typed.empty());
+	typed = std::move(moved);
+	REQUIRE(copies == 0);
+	REQUIRE(static_cast<std::string>(typed) == "abc");
+
+	auto erased = fsv::filtered_string_view{text, counted(&copies, {','})};
+	REQUIRE(copies == 0);
+	auto views = std::vector<fsv::filtered_string_view>();
+	for (int i = 0; i < 100; ++i) {
+		views.push_back(erased);
+	}
+	auto target = std::move(erased);
+	REQUIRE(copies == 0);
+	REQUIRE(views[99] == target);
+	REQUIRE(static_cast<std::string>(target) == "ab;c");
+
+	// A moved-from filter view accepts everything rather than holding an empty std::function
+	REQUIRE(erased.size() == 0);
+	REQUIRE(erased.predicate()('x'));
+	REQUIRE(!erased.contains("x"));
+}
+
+TEST_CASE("Variadic compose Fuses its Operands") {
+	const auto text = std::string("Hello, World! 42 times; or 7?");
+	const auto sv = fsv::filtered_string_view{text, fsv::char_set{"!"}};
+	const auto letters = fsv::char_set{"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"};
+	const auto lower = fsv::char_set{"abcdefghijklmnopqrstuvwxyz"};
+	const auto not_o = ~fsv::char_set{"o"};
+
+	// Tables are ANDed into one table, so the result keeps the vector kernels
+	auto tables = fsv::compose(sv, letters, lower, not_o);
+	STATIC_REQUIRE(std::same_as<decltype(tables), fsv::basic_filtered_string_view<fsv::char_set>>);
+	REQUIRE(tables.predicate() == (lower & not_o));
+	REQUIRE(static_cast<std::string>(tables) == "ellrldtimesr");
+
+	// Anything else is chained into one inlined predicate, with the same result as the vector form
+	auto is_digit = [](const char& c) { return c >= '0' && c <= '9'; };
+	auto not_four = [](const char& c) { return c != '4'; };
+	auto chained = fsv::compose(sv, is_digit, not_four, fsv::char_set{"0123456789"});
+	STATIC_REQUIRE(std::same_as<decltype(chained)::predicate_type,
+	                            fsv::conjunction<decltype(is_digit), decltype(not_four), fsv::char_set>>);
+	REQUIRE(static_cast<std::string>(chained) == "27");
+	const auto erased = fsv::compose(sv, std::vector<fsv::filter>{is_digit, not_four, fsv::char_set{"0123456789"}});
+	REQUIRE(static_cast<std::string>(chained) == static_cast<std::string>(erased));
+
+	// Operands are tried in order and stop at the first rejection
+	auto calls = 0;
+	auto counting = [&calls](const char&) {
+		++calls;
+		return true;
+	};
+	REQUIRE(fsv::compose(sv, [](const char& c) { return c == 'H'; }, counting).size() == 1);
+	REQUIRE(calls == 1);
+}
+
+TEST_CASE("Dynamic compose Tries the Most Selective Filter First") {
+	auto text = std::string(1 << 20, 'x');
+	for (std::size_t i = 0; i < text.size(); i += 10) {
+		text[i] = static_cast<char>('a' + i % 26);
+	}
+	auto lenient_calls = std::size_t{0};
+	auto lenient = [&lenient_calls](const char& c) {
+		++lenient_calls;
+		return c != 'q';
+	};
+	auto not_x = [](const char& c) { return c != 'x'; };
+	const auto expected = static_cast<std::size_t>(
+	    std::count_if(text.begin(), text.end(), [](char c) { return c != 'x' && c != 'q'; }));
+
+	// Listed first, the lenient filter would see every character; once the order adapts it sees only the
+	// tenth that get past not_x, plus the sampled calls
+	auto sv = fsv::compose(fsv::filtered_string_view{text}, {lenient, not_x});
+	REQUIRE(sv.size() == expected);
+	REQUIRE(lenient_calls < text.size() / 5);
+
+	// Each composition samples on its own schedule, so two called in strict alternation both reorder
+	auto other_calls = std::size_t{0};
+	auto other_lenient = [&other_calls](const char& c) {
+		++other_calls;
+		return c != 'q';
+	};
+	lenient_calls = 0;
+	const auto one = fsv::compose(fsv::filtered_string_view{text}, {lenient, not_x});
+	const auto two = fsv::compose(fsv::filtered_string_view{text}, {other_lenient, not_x});
+	auto accepted = std::array<std::size_t, 2>{};
+	for (const char c : text) {
+		accepted[0] += one.predicate()(c) ? 1U : 0U;
+		accepted[1] += two.predicate()(c) ? 1U : 0U;
+	}
+	REQUIRE(accepted[0] == expected);
+	REQUIRE(accepted[1] == expected);
+	REQUIRE(lenient_calls < text.size() / 5);
+	REQUIRE(other_calls < text.size() / 5);
+
+	// Once reranking keeps confirming the order, sampling backs off: beyond the characters not_x lets
+	// through, the lenient filter sees far fewer than one sample per min_sample_period calls
+	lenient_calls = 0;
+	const auto settled = fsv::compose(fsv::filtered_string_view{text}, {not_x, lenient});
+	REQUIRE(settled.size() == expected);
+	const auto passed = static_cast<std::size_t>(std::count_if(text.begin(), text.end(), not_x));
+	REQUIRE(lenient_calls - passed < text.size() / 1024);
+
+	// One composed predicate shared across threads gives the same answer everywhere
+	const auto shared = fsv::compose(fsv::filtered_string_view{text}, {[](const char& c) { return c != 'q'; }, not_x});
+	auto counts = std::vector<std::size_t>(4);
+	{
+		auto threads = std::vector<std::jthread>();
+		for (auto& count : counts) {
+			threads.emplace_back([&shared, &count] { count = static_cast<std::string>(shared).size(); });
+		}
+	}
+	for (const auto count : counts) {
+		REQUIRE(count == expected);
+	}
+}
+
+TEST_CASE("Views Model the Standard Range Concepts") {
+	using stateless = fsv::basic_filtered_string_view<fsv::accept_all>;
+	using table = fsv::basic_filtered_string_view<fsv::char_set>;
+	STATIC_REQUIRE(std::ranges::view<fsv::filtered_string_view>);
+	STATIC_REQUIRE(std::ranges::bidirectional_range<fsv::filtered_string_view>);
+	STATIC_REQUIRE(std::ranges::common_range<fsv::filtered_string_view>);
+	STATIC_REQUIRE(std::ranges::sized_range<const fsv::filtered_string_view>);
+	STATIC_REQUIRE(std::ranges::view<table>);
+	STATIC_REQUIRE(std::ranges::borrowed_range<stateless>);
+	STATIC_REQUIRE(!std::ranges::borrowed_range<table>);
+	STATIC_REQUIRE(!std::ranges::borrowed_range<fsv::filtered_string_view>);
+	STATIC_REQUIRE(std::sentinel_for<std::default_sentinel_t, std::ranges::iterator_t<fsv::filtered_string_view>>);
+
+	const auto text = std::string("a1b2c3d4e5");
+	const auto digits = fsv::basic_filtered_string_view{text, fsv::char_set{"0123456789"}};
+
+	// Lazy pipelines with no intermediate strings
+	auto doubled = digits | std::views::drop(1) | std::views::take(3)
+	               | std::views::transform([](char c) { return 2 * (c - '0'); }) | std::views::common;
+	REQUIRE(std::vector<int>(doubled.begin(), doubled.end()) == std::vector<int>{4, 6, 8});
+	auto backwards = digits | std::views::reverse;
+	REQUIRE(std::string(backwards.begin(), backwards.end()) == "54321");
+	REQUIRE(std::ranges::size(digits) == 5);
+	REQUIRE(std::ranges::count(digits, '3') == 1);
+
+	// Iterators end where the default sentinel says they do
+	auto steps = 0;
+	for (auto it = digits.begin(); it != std::default_sentinel; ++it) {
+		++steps;
+	}
+	REQUIRE(steps == 5);
+	REQUIRE(std::ranges::distance(digits.begin(), std::default_sentinel) == 5);
+
+	// A borrowed view's iterators stay usable after the view itself is gone
+	auto is_digit = [](const char& c) { return c >= '0' && c <= '9'; };
+	STATIC_REQUIRE(std::ranges::borrowed_range<fsv::basic_filtered_string_view<decltype(is_digit)>>);
+	const auto found = std::ranges::find(fsv::basic_filtered_string_view{text, is_digit}, '4');
+	REQUIRE(*found == '4');
+	REQUIRE(*std::next(found) == '5');
+
+	// Views over capturing lambdas are views too, and pipelines over them can be assigned
+	const auto low = '3';
+	auto above = [low](const char& c) { return c > low && c <= '9'; };
+	using capturing = fsv::basic_filtered_string_view<decltype(above)>;
+	STATIC_REQUIRE(std::ranges::view<capturing>);
+	STATIC_REQUIRE(!std::ranges::borrowed_range<capturing>);
+	const auto to_int = [](char c) { return c - '0'; };
+	auto values = fsv::basic_filtered_string_view{text, above} | std::views::transform(to_int);
+	const auto other = std::string("x9y8");
+	const auto replacement = fsv::basic_filtered_string_view{other, above} | std::views::transform(to_int);
+	REQUIRE(std::vector<int>(values.begin(), values.end()) == std::vector<int>{4, 5});
+	values = replacement;
+	REQUIRE(std::vector<int>(values.begin(), values.end()) == std::vector<int>{9, 8});
+}
+
+TEST_CASE("Lazy Split Range") {
+	STATIC_REQUIRE(std::ranges::view<fsv::split_view<fsv::filter>>);
+	STATIC_REQUIRE(std::ranges::forward_range<fsv::split_view<fsv::char_set>>);
+
+	auto sv = fsv::filtered_string_view{"a1,,b2,c3,", fsv::char_set{"abc,"}};
+	auto fields = std::vector<std::string>();
+	for (auto field : fsv::split_range(sv, ",")) {
+		fields.push_back(static_cast<std::string>(field));
+	}
+	REQUIRE(fields == std::vector<std::string>{"a", "", "b", "c", ""});
+	REQUIRE(std::ranges::distance(fsv::split_range(sv, ",")) == std::ranges::ssize(fsv::split(sv, ",")));
+
+	// Only the segments that are reached are searched for
+	auto line = std::string("x;y;z") + std::string(1000, ';');
+	auto first_two = std::vector<std::string>();
+	for (auto field : fsv::split_range(fsv::filtered_string_view{line}, ";") | std::views::take(2)) {
+		first_two.push_back(static_cast<std::string>(field));
+	}
+	REQUIRE(first_two == std::vector<std::string>{"x", "y"});
+
+	REQUIRE(std::ranges::distance(fsv::split_range(fsv::filtered_string_view{"abc"}, "")) == 1);
+	REQUIRE(fsv::split_range(fsv::filtered_string_view{""}, ",").front() == "");
+}
+
+TEST_CASE("Split on a Character Class") {
+	auto collect = [](auto&& segments) {
+		auto result = std::vector<std::string>();
+		for (auto segment : segments) {
+			result.push_back(static_cast<std::string>(segment));
+		}
+		return result;
+	};
+	const auto space = fsv::char_set{" \t\n"};
+	auto text = fsv::filtered_string_view{"  the quick\tbrown\n\nfox "};
+
+	REQUIRE(collect(fsv::split_if(text, space, fsv::split_mode::collapse))
+	        == std::vector<std::string>{"the", "quick", "brown", "fox"});
+	REQUIRE(collect(fsv::split_if(text, space))
+	        == std::vector<std::string>{"", "", "the", "quick", "brown", "", "fox", ""});
+
+	// A type-erased delimiter and a plain lambda split the same way
+	REQUIRE(collect(fsv::split_if(text, fsv::filter(space), fsv::split_mode::collapse)).size() == 4);
+	auto is_punct = [](const char& c) { return std::ispunct(static_cast<unsigned char>(c)) != 0; };
+	REQUIRE(collect(fsv::split_if(fsv::filtered_string_view{"a.b,c!"}, is_punct))
+	        == std::vector<std::string>{"a", "b", "c", ""});
+
+	// Segments keep the view's own predicate
+	auto vowels = fsv::filtered_string_view{"banana split", fsv::char_set{"aeiou "}};
+	REQUIRE(collect(fsv::split_if(vowels, space)) == std::vector<std::string>{"aaa", "i"});
+
+	REQUIRE(collect(fsv::split_if(fsv::filtered_string_view{""}, space)) == std::vector<std::string>{""});
+	REQUIRE(std::ranges::empty(fsv::split_if(fsv::filtered_string_view{" \n "}, space, fsv::split_mode::collapse)));
+	STATIC_REQUIRE(std::ranges::forward_range<fsv::split_if_view<fsv::filter, fsv::char_set>>);
+}
+
+TEST_CASE("Multi-Byte Delimiters and find") {
+	auto payload = std::string("GET / HTTP/1.1\r\nHost: a\r\n\r\nbody one\r\n\r\n\r\n\r\nbody two");
+	auto parts = fsv::split(fsv::filtered_string_view{payload}, "\r\n\r\n");
+	REQUIRE(parts.size() == 4);
+	REQUIRE(parts[0] == "GET / HTTP/1.1\r\nHost: a");
+	REQUIRE(parts[1] == "body one");
+	REQUIRE(parts[2] == "");
+	REQUIRE(parts[3] == "body two");
+
+	auto sv = fsv::filtered_string_view{payload};
+	REQUIRE(sv.find("\r\n\r\n") == 23);
+	REQUIRE(sv.find("\r\n\r\n", 24) == 35);
+	REQUIRE(sv.find("missing") == fsv::filtered_string_view::npos);
+	REQUIRE(sv.find("") == 0);
+	REQUIRE(sv.find("", payload.size()) == payload.size());
+	REQUIRE(sv.find("", payload.size() + 1) == fsv::filtered_string_view::npos);
+
+	// Indices count filtered characters, and matches may span rejected ones
+	auto is_letter = [](const char& c) { return std::isdigit(static_cast<unsigned char>(c)) == 0; };
+	auto no_digits = fsv::filtered_string_view{"ab1c2abc", is_letter};
+	REQUIRE(no_digits.find("abc") == 0);
+	REQUIRE(no_digits.find("abc", 1) == 3);
+	REQUIRE(no_digits.find("cab") == 2);
+	REQUIRE(no_digits.find("1") == fsv::filtered_string_view::npos);
+	REQUIRE(no_digits.find("", 6) == 6);
+}
+
+TEST_CASE("Parallel Split Matches split") {
+	auto lines = std::string();
+	for (int i = 0; lines.size() < (std::size_t{5} << 20); ++i) {
+		lines += "record " + std::to_string(i) + (i % 7 == 0 ? "\n\n" : "\n");
+	}
+	auto digits = fsv::filtered_string_view{lines, fsv::char_set{"0123456789"}};
+	const auto expected = fsv::split(digits, "\n");
+	for (const std::size_t threads : {0U, 1U, 4U}) {
+		const auto parts = fsv::split_parallel(digits, "\n", threads);
+		REQUIRE(parts.size() == expected.size());
+		REQUIRE(std::equal(parts.begin(), parts.end(), expected.begin(), [](const auto& lhs, const auto& rhs) {
+			return lhs.raw().data() == rhs.raw().data() && lhs.raw().size() == rhs.raw().size();
+		}));
+	}
+	REQUIRE(fsv::split_parallel(digits, "").size() == 1);
+	REQUIRE(fsv::split_parallel(fsv::filtered_string_view{"a,b,"}, ",").back() == "");
+}
+
+TEST_CASE("Searching Filtered Content") {
+	auto gen = std::mt19937(6771);
+	auto letter = std::uniform_int_distribution<int>('a', 'e');
+	auto text = std::string(9000, ' ');
+	for (auto& c : text) {
+		c = static_cast<char>(letter(gen));
+	}
+	const auto no_e = [](const char& c) { return c != 'e'; };
+	const auto check = [&text](const auto& sv) {
+		const auto filtered = static_cast<std::string>(sv);
+		for (const std::size_t m : {0U, 1U, 3U, 7U, 2500U}) {
+			for (const std::size_t start : {0U, 17U, 4090U, 5000U}) {
+				const auto needle = filtered.substr(start, m);
+				for (const std::size_t pos : {std::size_t{0}, std::size_t{4093}, filtered.size(), std::string::npos}) {
+					REQUIRE(sv.find(needle, pos) == filtered.find(needle, pos));
+					REQUIRE(sv.rfind(needle, pos) == filtered.rfind(needle, pos));
+				}
+				const auto found = sv.find_match(needle, start);
+				REQUIRE(found.has_value());
+				REQUIRE(found->index == start);
+				if (!needle.empty()) {
+					REQUIRE(text[found->offset] == needle.front());
+				}
+				const auto last = sv.rfind_match(needle);
+				REQUIRE(last->index == filtered.rfind(needle));
+				REQUIRE(fsv::substr(sv, static_cast<int>(last->index)).raw().data() == text.data() + last->offset);
+			}
+		}
+		REQUIRE(sv.contains("abcde") == (filtered.find("abcde") != std::string::npos));
+		REQUIRE(sv.contains("dead") == (filtered.find("dead") != std::string::npos));
+		REQUIRE(sv.starts_with(filtered.substr(0, 100)));
+		REQUIRE(!sv.starts_with(filtered.substr(0, 99) + "?"));
+		REQUIRE(sv.ends_with(filtered.substr(filtered.size() - 100)));
+		REQUIRE(!sv.ends_with("?" + filtered.substr(filtered.size() - 99)));
+	};
+	check(fsv::filtered_string_view{text});
+	check(fsv::filtered_string_view{text, fsv::char_set{"abcd"}});
+	check(fsv::basic_filtered_string_view{text, no_e});
+
+	auto sv = fsv::filtered_string_view{"a-b-c", [](const char& c) { return c != '-'; }};
+	REQUIRE(sv.contains("bc"));
+	REQUIRE(sv.find_match("bc")->offset == 2);
+	REQUIRE(sv.starts_with("ab"));
+	REQUIRE(sv.ends_with("abc"));
+	REQUIRE(!sv.ends_with("xabc"));
+	REQUIRE(sv.starts_with(""));
+	REQUIRE(fsv::filtered_string_view{""}.ends_with(""));
+}
+
+TEST_CASE("Searching a Default-Constructed View") {
+	// Its buffer is a null pointer, which must never reach memchr or memcmp
+	const auto empty = fsv::filtered_string_view{};
+	REQUIRE(empty.find("a") == fsv::filtered_string_view::npos);
+	REQUIRE(empty.find("ab") == fsv::filtered_string_view::npos);
+	REQUIRE(empty.find("") == 0);
+	REQUIRE(empty.rfind("a") == fsv::filtered_string_view::npos);
+	REQUIRE(!empty.contains("a"));
+	REQUIRE(!empty.contains("abc"));
+	REQUIRE(empty.contains(""));
+	REQUIRE(!empty.starts_with("a"));
+	REQUIRE(!empty.ends_with("a"));
+
+	for (const auto* delim : {",", ", "}) {
+		const auto parts = fsv::split(empty, delim);
+		REQUIRE(parts.size() == 1);
+		REQUIRE(parts.front() == "");
+		REQUIRE(std::ranges::distance(fsv::split_range(empty, delim)) == 1);
+		REQUIRE(fsv::split_parallel(empty, delim).size() == 1);
+	}
+}
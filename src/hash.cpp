@@ -0,0 +1,131 @@
+#include "./hash.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace fsv::detail {
+	namespace {
+		constexpr auto shift_mix(std::uint64_t v) noexcept -> std::uint64_t {
+			return v ^ (v >> 47U);
+		}
+
+		// wyhash's constants and its multiply-and-fold mixer
+		constexpr auto secret = std::array<std::uint64_t, 3>{
+			0xa0761d6478bd642fU,
+			0xe7037ed1a0b428dbU,
+			0x8ebc6af09c88c6e3U,
+		};
+
+		auto mum(std::uint64_t a, std::uint64_t b) noexcept -> std::uint64_t {
+			__extension__ typedef unsigned __int128 uint128;
+			const auto product = static_cast<uint128>(a) * b;
+			return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64U);
+		}
+
+		auto read64(const char* p) noexcept -> std::uint64_t {
+			auto word = std::uint64_t{0};
+			std::memcpy(&word, p, sizeof(word));
+			return word;
+		}
+	} // namespace
+
+	// Length Constructor
+	string_hash_stream::string_hash_stream(std::size_t length) noexcept
+	: _hash(seed ^ (static_cast<std::uint64_t>(length) * mul))
+	, _pending(0)
+	, _pending_size(0) {}
+
+	// update Member Function: whole words straight from the input, partial ones collected little-endian
+	void string_hash_stream::update(std::string_view bytes) noexcept {
+		const char* p = bytes.data();
+		auto n = bytes.size();
+		if (_pending_size != 0) {
+			const auto take = std::min(n, 8 - _pending_size);
+			for (std::size_t i = 0; i < take; ++i) {
+				_pending |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * (_pending_size + i));
+			}
+			_pending_size += take;
+			p += take;
+			n -= take;
+			if (_pending_size < 8) {
+				return;
+			}
+			mix(_pending);
+			_pending = 0;
+			_pending_size = 0;
+		}
+		for (; n >= 8; p += 8, n -= 8) {
+			auto word = std::uint64_t{0};
+			std::memcpy(&word, p, sizeof(word));
+			mix(word);
+		}
+		for (std::size_t i = 0; i < n; ++i) {
+			_pending |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+		}
+		_pending_size = n;
+	}
+
+	// result Member Function: the trailing partial word is folded in unmixed, then the final avalanche
+	auto string_hash_stream::result() const noexcept -> std::size_t {
+		auto hash = _hash;
+		if (_pending_size != 0) {
+			hash ^= _pending;
+			hash *= mul;
+		}
+		hash = shift_mix(hash) * mul;
+		return static_cast<std::size_t>(shift_mix(hash));
+	}
+
+	// Mix One Full Word into the Hash
+	void string_hash_stream::mix(std::uint64_t word) noexcept {
+		_hash ^= shift_mix(word * mul) * mul;
+		_hash *= mul;
+	}
+
+	// Block Hash Default Constructor
+	block_hash_stream::block_hash_stream() noexcept
+	: _state(secret[0])
+	, _length(0)
+	, _pending()
+	, _pending_size(0) {}
+
+	// update Member Function: whole blocks straight from the input, a partial one buffered
+	void block_hash_stream::update(std::string_view bytes) noexcept {
+		const char* p = bytes.data();
+		auto n = bytes.size();
+		_length += n;
+		if (_pending_size != 0) {
+			const auto take = std::min(n, block_size - _pending_size);
+			std::memcpy(_pending.data() + _pending_size, p, take);
+			_pending_size += take;
+			p += take;
+			n -= take;
+			if (_pending_size < block_size) {
+				return;
+			}
+			mix(_pending.data());
+			_pending_size = 0;
+		}
+		for (; n >= block_size; p += block_size, n -= block_size) {
+			mix(p);
+		}
+		std::memcpy(_pending.data(), p, n);
+		_pending_size = n;
+	}
+
+	// result Member Function: the zero-padded partial block, then the length
+	auto block_hash_stream::result() const noexcept -> std::size_t {
+		auto state = _state;
+		if (_pending_size != 0) {
+			auto last = std::array<char, block_size>{};
+			std::memcpy(last.data(), _pending.data(), _pending_size);
+			state = mum(read64(last.data()) ^ secret[1], read64(last.data() + 8) ^ state ^ _pending_size);
+		}
+		return static_cast<std::size_t>(mum(state ^ secret[2], _length ^ secret[1]));
+	}
+
+	// Fold One 16-Byte Block into the State
+	void block_hash_stream::mix(const char* block) noexcept {
+		_state = mum(read64(block) ^ secret[1], read64(block + 8) ^ _state);
+	}
+} // namespace fsv::detail
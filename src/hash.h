@@ -0,0 +1,63 @@
+#ifndef COMP6771_ASS2_HASH_H
+#define COMP6771_ASS2_HASH_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace fsv::detail {
+	// The standard library's string hash computed incrementally: fed the same bytes in any number of
+	// pieces, result() equals std::hash<std::string_view> of their concatenation. The length must be known
+	// up front because the hash is seeded with it.
+	//
+	// This reproduces libstdc++'s 64-bit _Hash_bytes (MurmurHash2 over 8-byte words). Elsewhere
+	// reproduces_std is false and callers hash a gathered copy instead.
+	class string_hash_stream {
+	 public:
+#if defined(__GLIBCXX__)
+		static constexpr bool reproduces_std = sizeof(std::size_t) == 8 && std::endian::native == std::endian::little;
+#else
+		static constexpr bool reproduces_std = false;
+#endif
+
+		explicit string_hash_stream(std::size_t length) noexcept;
+
+		void update(std::string_view bytes) noexcept;
+		auto result() const noexcept -> std::size_t;
+
+	 private:
+		static constexpr std::uint64_t seed = 0xc70f6907U;
+		static constexpr std::uint64_t mul = (std::uint64_t{0xc6a4a793U} << 32U) + 0x5bd1e995U;
+
+		std::uint64_t _hash;
+		std::uint64_t _pending;
+		std::size_t _pending_size;
+
+		void mix(std::uint64_t word) noexcept;
+	};
+
+	// A fast streaming hash in the style of wyhash: each 16-byte block is folded into the state with one
+	// 64x64->128-bit multiply, and the length is mixed in at the end, so nothing needs to be known up front.
+	// Any split of the same bytes into pieces gives the same result.
+	class block_hash_stream {
+	 public:
+		block_hash_stream() noexcept;
+
+		void update(std::string_view bytes) noexcept;
+		auto result() const noexcept -> std::size_t;
+
+	 private:
+		static constexpr std::size_t block_size = 16;
+
+		std::uint64_t _state;
+		std::uint64_t _length;
+		std::array<char, block_size> _pending;
+		std::size_t _pending_size;
+
+		void mix(const char* block) noexcept;
+	};
+} // namespace fsv::detail
+
+#endif // COMP6771_ASS2_HASH_H
@@ -0,0 +1,64 @@
+#include "./hash.h"
+#include "./filtered_string_view.h"
+
+#include <catch2/catch.hpp>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_set>
+
+TEST_CASE("string_hash_stream Reproduces std::hash in Any Pieces") {
+	// Other standard libraries hash differently and views gather their text instead
+	if (!fsv::detail::string_hash_stream::reproduces_std) {
+		return;
+	}
+	auto gen = std::mt19937(6771);
+	auto byte = std::uniform_int_distribution<int>(0, 255);
+	for (std::size_t n = 0; n < 80; ++n) {
+		auto text = std::string(n, '\0');
+		for (auto& c : text) {
+			c = static_cast<char>(byte(gen));
+		}
+		const auto expected = std::hash<std::string_view>{}(text);
+		for (std::size_t piece = 1; piece <= 9; ++piece) {
+			auto stream = fsv::detail::string_hash_stream(n);
+			for (std::size_t i = 0; i < n; i += piece) {
+				stream.update(std::string_view(text).substr(i, piece));
+			}
+			REQUIRE(stream.result() == expected);
+		}
+	}
+}
+
+TEST_CASE("Views Hash Like Their Filtered Text") {
+	// One filtered text reached through different buffers, predicates and run boundaries
+	const auto target = std::string_view("quick brown fox");
+	const auto expected = std::hash<std::string_view>{}(target);
+	const auto not_dash = [](const char& c) { return c != '-'; };
+	const auto lower = fsv::char_set{"abcdefghijklmnopqrstuvwxyz "};
+
+	const auto plain = fsv::filtered_string_view{target};
+	const auto typed = fsv::basic_filtered_string_view{"q-u-i-c-k b-r-o-w-n f-o-x-", not_dash};
+	const auto erased = fsv::filtered_string_view{"q-u-i-c-k b-r-o-w-n f-o-x-", not_dash};
+	const auto table = fsv::filtered_string_view{"QUICKquick BROWNbrown FOXfox!", lower};
+	const auto long_runs = fsv::filtered_string_view{"quick brown -----------------------fox", not_dash};
+	REQUIRE(std::hash<fsv::filtered_string_view>{}(plain) == expected);
+	REQUIRE(std::hash<std::decay_t<decltype(typed)>>{}(typed) == expected);
+	REQUIRE(std::hash<fsv::filtered_string_view>{}(erased) == expected);
+	REQUIRE(std::hash<fsv::filtered_string_view>{}(table) == expected);
+	REQUIRE(std::hash<fsv::filtered_string_view>{}(long_runs) == expected);
+
+	// Hashing leaves the view untouched, so a second call agrees with the first
+	REQUIRE(std::hash<fsv::filtered_string_view>{}(table) == expected);
+	REQUIRE(static_cast<std::string>(table) == target);
+
+	// Empty views hash like the empty string, whatever their buffer
+	const auto empty = std::hash<std::string_view>{}("");
+	REQUIRE(std::hash<fsv::filtered_string_view>{}(fsv::filtered_string_view{}) == empty);
+	REQUIRE(std::hash<fsv::filtered_string_view>{}(fsv::filtered_string_view{"abc", fsv::char_set{}}) == empty);
+
+	auto keys = std::unordered_set<fsv::filtered_string_view>();
+	keys.insert(fsv::filtered_string_view{"a-b-c", not_dash});
+	REQUIRE(keys.contains(fsv::filtered_string_view{"abc"}));
+	REQUIRE(!keys.contains(fsv::filtered_string_view{"ab"}));
+}
@@ -0,0 +1,25 @@
+#include "./isa.h"
+
+namespace fsv::detail {
+#if defined(FSV_X86_SIMD)
+	// Instruction Set Detection
+	auto detect_isa() noexcept -> isa {
+		static const isa level = [] {
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+			    && __builtin_cpu_supports("avx512vbmi2") && __builtin_cpu_supports("avx2")
+			    && __builtin_cpu_supports("popcnt")) {
+				return isa::avx512;
+			}
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+				return isa::avx2;
+			}
+			if (__builtin_cpu_supports("ssse3")) {
+				return isa::ssse3;
+			}
+			return isa::scalar;
+		}();
+		return level;
+	}
+#endif
+} // namespace fsv::detail
@@ -0,0 +1,19 @@
+#ifndef COMP6771_ASS2_ISA_H
+#define COMP6771_ASS2_ISA_H
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#	define FSV_X86_SIMD 1
+#endif
+
+namespace fsv::detail {
+#if defined(FSV_X86_SIMD)
+	// The widest instruction set the scanning kernels may use on this CPU. avx512 also requires AVX2 and
+	// VBMI2; kernels without an AVX-512 form treat it as avx2.
+	enum class isa { scalar, ssse3, avx2, avx512 };
+
+	// Detected once, on first use
+	auto detect_isa() noexcept -> isa;
+#endif
+} // namespace fsv::detail
+
+#endif // COMP6771_ASS2_ISA_H
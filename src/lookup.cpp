@@ -0,0 +1,10 @@
+#include "./lookup.h"
+
+namespace fsv {
+	// Text Hash Call Operator
+	auto hash::operator()(std::string_view text) const noexcept -> std::size_t {
+		auto stream = detail::block_hash_stream();
+		stream.update(text);
+		return stream.result();
+	}
+} // namespace fsv
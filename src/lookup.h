@@ -0,0 +1,102 @@
+#ifndef COMP6771_ASS2_LOOKUP_H
+#define COMP6771_ASS2_LOOKUP_H
+
+#include <array>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+#include "./filtered_string_view.h"
+#include "./hash.h"
+
+namespace fsv {
+	namespace detail {
+		template<typename T>
+		inline constexpr bool is_filtered_view = false;
+
+		template<typename Pred>
+		inline constexpr bool is_filtered_view<basic_filtered_string_view<Pred>> = true;
+
+		// Anything the lookup functors accept: a filtered view of any predicate, or plain text
+		template<typename T>
+		concept text = is_filtered_view<std::remove_cvref_t<T>> || std::convertible_to<const T&, std::string_view>;
+
+		// The characters of a text as a range of string_view runs, for compare_runs
+		template<text T>
+		auto text_runs(const T& x) {
+			if constexpr (is_filtered_view<T>) {
+				return x.runs();
+			}
+			else {
+				return std::array<std::string_view, 1>{std::string_view(x)};
+			}
+		}
+	} // namespace detail
+
+	// Transparent hash for containers keyed by std::string. A view hashes exactly like the string holding
+	// its filtered text, so a std::unordered_map<std::string, V, fsv::hash, fsv::equal> can be probed with
+	// a view without materialising it. Views are streamed run by run through detail::block_hash_stream,
+	// which is not std::hash: keys and probes must both go through this functor.
+	struct hash {
+		using is_transparent = void;
+
+		auto operator()(std::string_view text) const noexcept -> std::size_t;
+		template<typename Pred>
+		auto operator()(const basic_filtered_string_view<Pred>& view) const -> std::size_t;
+	};
+
+	// Transparent equality between strings and views, comparing run by run and stopping at the first
+	// difference
+	struct equal {
+		using is_transparent = void;
+
+		template<detail::text Lhs, detail::text Rhs>
+		auto operator()(const Lhs& lhs, const Rhs& rhs) const -> bool;
+	};
+
+	// Transparent ordering between strings and views for std::map and std::set, with the same
+	// lexicographic order as std::string
+	struct less {
+		using is_transparent = void;
+
+		template<detail::text Lhs, detail::text Rhs>
+		auto operator()(const Lhs& lhs, const Rhs& rhs) const -> bool;
+	};
+
+	// View Hash Call Operator
+	template<typename Pred>
+	auto hash::operator()(const basic_filtered_string_view<Pred>& view) const -> std::size_t {
+		if (detail::scanner<Pred>(view.predicate()).accepts_all()) {
+			return (*this)(view.raw());
+		}
+		auto stream = detail::block_hash_stream();
+		view.for_each_run([&stream](std::string_view run) { stream.update(run); });
+		return stream.result();
+	}
+
+	// Equality Call Operator
+	template<detail::text Lhs, detail::text Rhs>
+	auto equal::operator()(const Lhs& lhs, const Rhs& rhs) const -> bool {
+		if constexpr (!detail::is_filtered_view<Lhs> && !detail::is_filtered_view<Rhs>) {
+			return std::string_view(lhs) == std::string_view(rhs);
+		}
+		else {
+			return std::is_eq(detail::compare_runs(detail::text_runs(lhs), detail::text_runs(rhs)));
+		}
+	}
+
+	// Ordering Call Operator
+	template<detail::text Lhs, detail::text Rhs>
+	auto less::operator()(const Lhs& lhs, const Rhs& rhs) const -> bool {
+		if constexpr (!detail::is_filtered_view<Lhs> && !detail::is_filtered_view<Rhs>) {
+			return std::string_view(lhs) < std::string_view(rhs);
+		}
+		else {
+			return std::is_lt(detail::compare_runs(detail::text_runs(lhs), detail::text_runs(rhs)));
+		}
+	}
+} // namespace fsv
+
+#endif // COMP6771_ASS2_LOOKUP_H
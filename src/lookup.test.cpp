@@ -0,0 +1,116 @@
+#include "./lookup.h"
+
+#include <catch2/catch.hpp>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+TEST_CASE("Unordered Sets Find Every Member Through a View and Nothing Else") {
+	// Words hidden in noise that a char_set filters back out, so each probe hashes a view made of many runs
+	auto gen = std::mt19937(6771);
+	auto letter = std::uniform_int_distribution<int>('a', 'z');
+	auto length = std::uniform_int_distribution<std::size_t>(1, 40);
+	auto words = std::unordered_set<std::string, fsv::hash, fsv::equal>();
+	while (words.size() < 200) {
+		auto word = std::string(length(gen), ' ');
+		for (auto& c : word) {
+			c = static_cast<char>(letter(gen));
+		}
+		words.insert(word);
+	}
+	const auto letters = fsv::char_set{"abcdefghijklmnopqrstuvwxyz"};
+	const auto noisy = [](const std::string& word) {
+		auto result = std::string("#");
+		for (const char c : word) {
+			result += c;
+			result += "-#";
+		}
+		return result;
+	};
+
+	auto misses = 0;
+	for (const auto& word : words) {
+		const auto hidden = noisy(word);
+		REQUIRE(words.contains(fsv::filtered_string_view{hidden, letters}));
+
+		// A longer, shorter or altered word is a miss unless it happens to be a member too
+		auto altered = word;
+		altered.front() = altered.front() == 'q' ? 'r' : 'q';
+		for (const auto& near : {word + "a", word.substr(0, word.size() / 2), altered}) {
+			const auto probe = noisy(near);
+			const auto member = words.contains(near);
+			REQUIRE(words.contains(fsv::filtered_string_view{probe, letters}) == member);
+			misses += member ? 0 : 1;
+		}
+	}
+	REQUIRE(misses > 500);
+	// Filtering a probe down to nothing finds no word either
+	REQUIRE(!words.contains(fsv::filtered_string_view{"1234", letters}));
+
+	const auto hasher = fsv::hash{};
+	REQUIRE(hasher("abc") != hasher("abd"));
+	REQUIRE(hasher("") != hasher(std::string_view("\0", 1)));
+}
+
+TEST_CASE("block_hash_stream Is Independent of Chunking") {
+	auto gen = std::mt19937(6771);
+	auto byte = std::uniform_int_distribution<int>(0, 255);
+	for (std::size_t n = 0; n < 70; ++n) {
+		auto text = std::string(n, '\0');
+		for (auto& c : text) {
+			c = static_cast<char>(byte(gen));
+		}
+		const auto expected = fsv::hash{}(text);
+		for (std::size_t piece = 1; piece <= 17; ++piece) {
+			auto stream = fsv::detail::block_hash_stream();
+			for (std::size_t i = 0; i < n; i += piece) {
+				stream.update(std::string_view(text).substr(i, piece));
+			}
+			REQUIRE(stream.result() == expected);
+		}
+	}
+}
+
+TEST_CASE("Unordered Maps Keyed by std::string Can Be Probed With Views") {
+	auto counts = std::unordered_map<std::string, int, fsv::hash, fsv::equal>{{"abc", 1}, {"hello world", 2}};
+	const auto no_dashes = [](const char& c) { return c != '-'; };
+
+	REQUIRE(counts.find(fsv::basic_filtered_string_view{"a-b-c", no_dashes}) != counts.end());
+	REQUIRE(counts.find(fsv::basic_filtered_string_view{"a-b-c", no_dashes})->second == 1);
+	REQUIRE(counts.contains(fsv::filtered_string_view{"h#ello w#orld#", ~fsv::char_set{"#"}}));
+	REQUIRE(!counts.contains(fsv::filtered_string_view{"ab"}));
+	REQUIRE(counts.contains(std::string_view("abc")));
+	REQUIRE(counts.count(fsv::filtered_string_view{"xabcx", fsv::char_set{"abc"}}) == 1);
+}
+
+TEST_CASE("Ordered Maps Keyed by std::string Can Be Probed With Views") {
+	auto words = std::map<std::string, int, fsv::less>{{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+	const auto letters = fsv::char_set{"abcdefghijklmnopqrstuvwxyz"};
+
+	REQUIRE(words.find(fsv::filtered_string_view{"b-a-n-a-n-a", letters})->second == 2);
+	REQUIRE(words.contains(fsv::filtered_string_view{"  apple  ", letters}));
+	REQUIRE(!words.contains(fsv::filtered_string_view{"app", letters}));
+	REQUIRE(words.lower_bound(fsv::filtered_string_view{"b", letters})->first == "banana");
+	REQUIRE(words.upper_bound(fsv::filtered_string_view{"banana!", letters})->first == "cherry");
+
+	auto keys = std::set<std::string, fsv::less>{"a", "ab", "b"};
+	REQUIRE(keys.contains(fsv::basic_filtered_string_view{"a_b", [](const char& c) { return c != '_'; }}));
+}
+
+TEST_CASE("fsv::less Orders Views Like Their Strings") {
+	const auto strings = std::vector<std::string>{"", "a", "ab", "abc", "abd", "b", "\x80", "z"};
+	const auto vowels_out = [](const char& c) { return c != 'e'; };
+	for (const auto& lhs : strings) {
+		for (const auto& rhs : strings) {
+			const auto padded = lhs + "eee";
+			const auto view = fsv::basic_filtered_string_view{padded, vowels_out};
+			CHECK(fsv::less{}(view, rhs) == (lhs < rhs));
+			CHECK(fsv::less{}(rhs, view) == (rhs < lhs));
+			CHECK(fsv::equal{}(view, rhs) == (lhs == rhs));
+		}
+	}
+}
@@ -0,0 +1,81 @@
+#include "./rank_select.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace fsv::detail {
+	// Bitmap Constructor
+	rank_select::rank_select(std::vector<std::uint64_t> words)
+	: _words(std::move(words))
+	, _block_ranks() {
+		_block_ranks.reserve(_words.size() / words_per_block + 2);
+		std::size_t total = 0;
+		for (std::size_t i = 0; i < _words.size(); ++i) {
+			if (i % words_per_block == 0) {
+				_block_ranks.push_back(total);
+			}
+			total += static_cast<std::size_t>(std::popcount(_words[i]));
+		}
+		_block_ranks.push_back(total);
+	}
+
+	// size Member Function
+	auto rank_select::size() const noexcept -> std::size_t {
+		return _block_ranks.empty() ? 0 : _block_ranks.back();
+	}
+
+	// rank Member Function: set bits in [0, pos)
+	auto rank_select::rank(std::size_t pos) const noexcept -> std::size_t {
+		const std::size_t word = pos / 64;
+		if (word >= _words.size()) {
+			return size();
+		}
+		const std::size_t block = word / words_per_block;
+		std::size_t result = _block_ranks[block];
+		for (std::size_t i = block * words_per_block; i < word; ++i) {
+			result += static_cast<std::size_t>(std::popcount(_words[i]));
+		}
+		const std::uint64_t below = (std::uint64_t{1} << (pos % 64)) - 1;
+		return result + static_cast<std::size_t>(std::popcount(_words[word] & below));
+	}
+
+	// select Member Function: position of the k-th set bit (0-based), k < size()
+	auto rank_select::select(std::size_t k) const noexcept -> std::size_t {
+		const auto upper = std::upper_bound(_block_ranks.begin(), _block_ranks.end(), k);
+		const auto block = static_cast<std::size_t>(upper - _block_ranks.begin()) - 1;
+		k -= _block_ranks[block];
+
+		std::size_t word = block * words_per_block;
+		for (auto count = static_cast<std::size_t>(std::popcount(_words[word])); k >= count;
+		     count = static_cast<std::size_t>(std::popcount(_words[word]))) {
+			k -= count;
+			++word;
+		}
+
+		std::uint64_t bits = _words[word];
+		for (; k > 0; --k) {
+			bits &= bits - 1;
+		}
+		return word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+	}
+
+	// Set a Range of Bits
+	void set_bits(std::vector<std::uint64_t>& words, std::size_t first, std::size_t last) noexcept {
+		if (first >= last) {
+			return;
+		}
+		const std::size_t first_word = first / 64;
+		const std::size_t last_word = (last - 1) / 64;
+		const std::uint64_t head = ~std::uint64_t{0} << (first % 64);
+		const std::uint64_t tail = ~std::uint64_t{0} >> (63 - (last - 1) % 64);
+		if (first_word == last_word) {
+			words[first_word] |= head & tail;
+			return;
+		}
+		words[first_word] |= head;
+		std::fill(words.begin() + static_cast<std::ptrdiff_t>(first_word + 1),
+		          words.begin() + static_cast<std::ptrdiff_t>(last_word),
+		          ~std::uint64_t{0});
+		words[last_word] |= tail;
+	}
+} // namespace fsv::detail
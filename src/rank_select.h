@@ -0,0 +1,36 @@
+#ifndef COMP6771_ASS2_RANK_SELECT_H
+#define COMP6771_ASS2_RANK_SELECT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fsv::detail {
+	// Succinct rank/select over a bitmap of accepted positions.
+	//
+	// Cumulative counts are kept per block of 512 bits (one 64-bit count each, 1/8 of the bitmap's size), so
+	// rank is one lookup plus at most eight popcounts and select is a binary search over the blocks plus the
+	// same word scan.
+	class rank_select {
+	 public:
+		// Constructors
+		rank_select() noexcept = default;
+		explicit rank_select(std::vector<std::uint64_t> words);
+
+		// Member Functions
+		auto size() const noexcept -> std::size_t;
+		auto rank(std::size_t pos) const noexcept -> std::size_t;
+		auto select(std::size_t k) const noexcept -> std::size_t;
+
+	 private:
+		static constexpr std::size_t words_per_block = 8;
+
+		std::vector<std::uint64_t> _words;
+		std::vector<std::size_t> _block_ranks;
+	};
+
+	// Sets bits [first, last) of a bitmap stored as 64-bit words, least significant bit first
+	void set_bits(std::vector<std::uint64_t>& words, std::size_t first, std::size_t last) noexcept;
+} // namespace fsv::detail
+
+#endif // COMP6771_ASS2_RANK_SELECT_H
@@ -0,0 +1,42 @@
+#include "./rank_select.h"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+
+TEST_CASE("set_bits Ranges") {
+	auto words = std::vector<std::uint64_t>(3);
+	fsv::detail::set_bits(words, 3, 5);
+	REQUIRE(words[0] == 0b11000);
+	fsv::detail::set_bits(words, 60, 130);
+	REQUIRE(words[0] == (0b11000 | (std::uint64_t{0xF} << 60)));
+	REQUIRE(words[1] == ~std::uint64_t{0});
+	REQUIRE(words[2] == 0b11);
+	fsv::detail::set_bits(words, 150, 150);
+	REQUIRE(words[2] == 0b11);
+}
+
+TEST_CASE("rank_select Matches Linear Counting") {
+	auto gen = std::mt19937(6771);
+	for (const std::size_t bits : {0U, 1U, 63U, 64U, 65U, 511U, 512U, 513U, 5000U}) {
+		for (const double density : {0.0, 0.02, 0.5, 1.0}) {
+			auto coin = std::bernoulli_distribution(density);
+			auto words = std::vector<std::uint64_t>((bits + 63) / 64);
+			auto positions = std::vector<std::size_t>{};
+			for (std::size_t i = 0; i < bits; ++i) {
+				if (coin(gen)) {
+					fsv::detail::set_bits(words, i, i + 1);
+					positions.push_back(i);
+				}
+			}
+
+			const auto index = fsv::detail::rank_select(words);
+			REQUIRE(index.size() == positions.size());
+			for (std::size_t k = 0; k < positions.size(); ++k) {
+				REQUIRE(index.select(k) == positions[k]);
+				REQUIRE(index.rank(positions[k]) == k);
+			}
+			REQUIRE(index.rank(bits) == positions.size());
+		}
+	}
+}